@@ -0,0 +1,281 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: ziyidong.cs@gmail.com
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+
+#include "bench.h"
+
+
+typedef struct BenchOpInfo
+{
+    const char *name;
+    BenchUnit unit;
+} BenchOpInfo;
+
+static const BenchOpInfo bench_ops[] = {
+    {"point_mul_G1", BENCH_UNIT_NS},
+    {"point_add_G1", BENCH_UNIT_NS},
+    {"point_inv_G1", BENCH_UNIT_NS},
+    {"pow_G1", BENCH_UNIT_NS},
+    {"pow_G2", BENCH_UNIT_NS},
+    {"add_Zr", BENCH_UNIT_NS},
+    {"sub_Zr", BENCH_UNIT_NS},
+    {"mul_Zr", BENCH_UNIT_NS},
+    {"div_Zr", BENCH_UNIT_NS},
+    {"inv_Zr", BENCH_UNIT_NS},
+    {"mul_GT", BENCH_UNIT_NS},
+    {"div_GT", BENCH_UNIT_NS},
+    {"pow_GT", BENCH_UNIT_NS},
+    {"pairing", BENCH_UNIT_NS},
+    {"two_pairings", BENCH_UNIT_NS},
+    {"prod_pairing", BENCH_UNIT_NS},
+    {"id_to_Zr", BENCH_UNIT_NS},
+    {"bytes_to_G1", BENCH_UNIT_NS},
+    {"G2_to_Zr", BENCH_UNIT_NS},
+    {"hash_sha256", BENCH_UNIT_NS},
+    {"hash_sha256_32", BENCH_UNIT_NS},
+    {"hash_sha256_32_chains", BENCH_UNIT_NS},
+    {"hybrid_seal", BENCH_UNIT_NS},
+    {"hybrid_open", BENCH_UNIT_NS},
+    {"wots_keygen", BENCH_UNIT_NS},
+    {"wots_sign", BENCH_UNIT_NS},
+    {"wots_verify", BENCH_UNIT_NS},
+    {"cca_keygen", BENCH_UNIT_NS},
+    {"cca_trapdoor", BENCH_UNIT_NS},
+    {"cca_enc", BENCH_UNIT_NS},
+    {"cca_rkgen", BENCH_UNIT_NS},
+    {"cca_rjgen", BENCH_UNIT_NS},
+    {"cca_reenc", BENCH_UNIT_NS},
+    {"cca_dec1", BENCH_UNIT_NS},
+    {"cca_dec2", BENCH_UNIT_NS},
+    {"cca_sender_dec", BENCH_UNIT_NS},
+    {"sender_keygen", BENCH_UNIT_NS},
+    {"receiver_keygen", BENCH_UNIT_NS},
+    {"sender_enc", BENCH_UNIT_NS},
+    {"rk_rj_gen", BENCH_UNIT_NS},
+    {"reenc", BENCH_UNIT_NS},
+    {"receiver_dec", BENCH_UNIT_NS},
+    {"sender_dec", BENCH_UNIT_NS},
+    {"G1_bytes", BENCH_UNIT_BYTES},
+    {"G2_bytes", BENCH_UNIT_BYTES},
+    {"GT_bytes", BENCH_UNIT_BYTES},
+    {"ciphertext_bytes", BENCH_UNIT_BYTES},
+    {"reciphertext_bytes", BENCH_UNIT_BYTES},
+    {"redelta_bytes", BENCH_UNIT_BYTES},
+    {"rj_bytes", BENCH_UNIT_BYTES},
+    {"allocs_per_trade_warm", BENCH_UNIT_COUNT},
+    {"allocs_per_trade_cold", BENCH_UNIT_COUNT},
+};
+static_assert(sizeof(bench_ops) / sizeof(bench_ops[0]) == BENCH_OP_COUNT, "bench_ops must name every BenchOp");
+
+static const char *const bench_unit_names[] = {"ns", "B", "count"};
+
+const char *BenchOpName(BenchOp op)
+{
+    return bench_ops[op].name;
+}
+
+BenchUnit BenchOpUnit(BenchOp op)
+{
+    return bench_ops[op].unit;
+}
+
+uint64_t BenchNowNs()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+
+// Sorts samples in place
+static void bench_add(BenchReport &report, BenchOp op, const char *context, long iterations, std::vector<double> &samples)
+{
+    BenchResult result;
+    result.op = op;
+    result.context = context;
+    result.iterations = iterations;
+    result.samples = (int)samples.size();
+
+    size_t n = samples.size();
+    std::sort(samples.begin(), samples.end());
+    result.min = samples[0];
+    result.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    // nearest rank
+    result.p99 = samples[(size_t)ceil(0.99 * n) - 1];
+
+    double sum = 0;
+    for (double s : samples)
+    {
+        sum += s;
+    }
+    result.mean = sum / n;
+    double sq = 0;
+    for (double s : samples)
+    {
+        sq += (s - result.mean) * (s - result.mean);
+    }
+    result.stddev = n > 1 ? sqrt(sq / (n - 1)) : 0;
+
+    report.results.push_back(result);
+}
+
+void BenchRun(BenchReport &report, BenchOp op, const char *context, const std::function<void()> &body, int work)
+{
+    // warm-up, caches, arenas and lazily built tables settle here, and it gives the per-call estimate
+    long calls = 0;
+    uint64_t start = BenchNowNs(), elapsed;
+    do
+    {
+        body();
+        calls++;
+        elapsed = BenchNowNs() - start;
+    } while (elapsed < BENCH_WARMUP_NS);
+
+    uint64_t per_call = elapsed / calls;
+    long batch = per_call >= BENCH_SAMPLE_NS ? 1 : (long)(BENCH_SAMPLE_NS / (per_call + 1)) + 1;
+
+    std::vector<double> samples;
+    long iterations = 0;
+    uint64_t spent = 0;
+    while ((spent < BENCH_TARGET_NS || samples.size() < BENCH_MIN_SAMPLES) && samples.size() < BENCH_MAX_SAMPLES)
+    {
+        uint64_t t0 = BenchNowNs();
+        for (long i = 0; i < batch; i++)
+        {
+            body();
+        }
+        uint64_t t = BenchNowNs() - t0;
+        spent += t;
+        iterations += batch;
+        samples.push_back((double)t / batch / work);
+    }
+    bench_add(report, op, context, iterations, samples);
+}
+
+void BenchRunOnce(BenchReport &report, BenchOp op, const char *context, const std::function<void()> &body, int work)
+{
+    uint64_t t0 = BenchNowNs();
+    body();
+    std::vector<double> samples(1, (double)(BenchNowNs() - t0) / work);
+    bench_add(report, op, context, 1, samples);
+}
+
+void BenchRecordSamples(BenchReport &report, BenchOp op, const char *context, const double *samples_ns, int count, int work)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    std::vector<double> samples(samples_ns, samples_ns + count);
+    for (double &s : samples)
+    {
+        s /= work;
+    }
+    bench_add(report, op, context, count, samples);
+}
+
+void BenchRecordValue(BenchReport &report, BenchOp op, const char *context, double value)
+{
+    std::vector<double> samples(1, value);
+    bench_add(report, op, context, 0, samples);
+}
+
+
+void BenchPrint(BenchReport &report)
+{
+    for (BenchResult &r : report.results)
+    {
+        if (BenchOpUnit(r.op) != BENCH_UNIT_NS)
+        {
+            printf("%-24s %-32s %12.0f %s\n", BenchOpName(r.op), r.context.c_str(), r.median, bench_unit_names[BenchOpUnit(r.op)]);
+            continue;
+        }
+        printf("%-24s %-32s median %12.3f us, p99 %12.3f us, stddev %10.3f us, %ld calls\n", BenchOpName(r.op), r.context.c_str(),
+               r.median / 1e3, r.p99 / 1e3, r.stddev / 1e3, r.iterations);
+    }
+}
+
+// Contexts are file names and labels, quotes and backslashes are all that need escaping
+static void bench_put_json_string(FILE *file, const std::string &s)
+{
+    fputc('"', file);
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+        {
+            fputc('\\', file);
+        }
+        fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+static void bench_put_csv_string(FILE *file, const std::string &s)
+{
+    fputc('"', file);
+    for (char c : s)
+    {
+        if (c == '"')
+        {
+            fputc('"', file);
+        }
+        fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+int BenchWrite(BenchReport &report, const char *path_prefix)
+{
+    std::string json_path = std::string(path_prefix) + ".json";
+    std::string csv_path = std::string(path_prefix) + ".csv";
+    FILE *json = fopen(json_path.c_str(), "w");
+    FILE *csv = fopen(csv_path.c_str(), "w");
+    if (!json || !csv)
+    {
+        perror("[FAIL] Benchmark output open fail.");
+        if (json)
+        {
+            fclose(json);
+        }
+        if (csv)
+        {
+            fclose(csv);
+        }
+        return 0;
+    }
+
+    fprintf(json, "{\n  \"suite\": ");
+    bench_put_json_string(json, report.suite);
+    fprintf(json, ",\n  \"results\": [");
+    fprintf(csv, "suite,op,unit,context,iterations,samples,median,p99,mean,stddev,min\n");
+    for (size_t i = 0; i < report.results.size(); i++)
+    {
+        BenchResult &r = report.results[i];
+        const char *unit = bench_unit_names[BenchOpUnit(r.op)];
+
+        fprintf(json, "%s\n    {\"op\": \"%s\", \"unit\": \"%s\", \"context\": ", i ? "," : "", BenchOpName(r.op), unit);
+        bench_put_json_string(json, r.context);
+        fprintf(json, ", \"iterations\": %ld, \"samples\": %d, \"median\": %.3f, \"p99\": %.3f, \"mean\": %.3f, \"stddev\": %.3f, \"min\": %.3f}",
+                r.iterations, r.samples, r.median, r.p99, r.mean, r.stddev, r.min);
+
+        bench_put_csv_string(csv, report.suite);
+        fprintf(csv, ",%s,%s,", BenchOpName(r.op), unit);
+        bench_put_csv_string(csv, r.context);
+        fprintf(csv, ",%ld,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", r.iterations, r.samples, r.median, r.p99, r.mean, r.stddev, r.min);
+    }
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+    fclose(csv);
+    return 1;
+}
@@ -9,16 +9,24 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include <time.h>
 #include <iostream>
 #include "sha.h"
 #include "pbc.h"
+#include "registry.h"
 #include "wots.h"
 #include "bendmarking.h"
 #include "cpamaptozr.h"
-
-#define RENUM 10000
+#include "ccastruct.h"
+#include "ccamap.h"
+#include "hybrid.h"
+#include "hash.h"
+#include "bench.h"
+
+// Records per hybrid stream run, the first HYBRID_WARMUP are not recorded
+#define HYBRID_RENUM 4096
+#define HYBRID_WARMUP 64
 #define SHA256_DIGEST_LENGTH 32
 
 using namespace std;
@@ -53,37 +61,294 @@ void G2_to_Zr_via_hash(element_t z, element_t g2, pairing_t pairing) {
 }
 
 
-int bendmarking()
+// Decryption pairing cost per ciphertext: two pairings multiplied in GT
+// (before) against one element_prod_pairing call (after)
+static int bendmarking_prod_pairing(BenchReport &report, const char *param_file)
 {
+    int i;
+    pairing_ptr pairing;
+    element_t in1[2], in2[2];
+    element_t t1, t2, out;
 
-    FILE *file;
-    file = fopen("bendmarking_output.txt", "w");
-    if (!file)
+    pairing = PairingAcquire(param_file);
+    if (!pairing)
     {
-        perror("[Fail] Bendmarking_output.txt open fail.\n");
-        exit(1);
+        return 0;
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        element_init_G1(in1[i], pairing);
+        element_init_G2(in2[i], pairing);
+        element_random(in1[i]);
+        element_random(in2[i]);
+    }
+    element_init_GT(t1, pairing);
+    element_init_GT(t2, pairing);
+    element_init_GT(out, pairing);
+
+    // before: pairing_apply twice
+    BenchRun(report, BENCH_TWO_PAIRINGS, param_file, [&]() {
+        pairing_apply(t1, in1[0], in2[0], pairing);
+        pairing_apply(t2, in1[1], in2[1], pairing);
+        element_mul(out, t1, t2);
+    });
+
+    // after: shared Miller loop and final exponentiation
+    BenchRun(report, BENCH_PROD_PAIRING, param_file, [&]() {
+        element_prod_pairing(t1, in1, in2, 2);
+    });
+
+    if (element_cmp(out, t1))
+    {
+        printf("[Fail] Product of pairings mismatch on %s.\n", param_file);
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        element_clear(in1[i]);
+        element_clear(in2[i]);
     }
-    fprintf(file, "=== Bendmarking Test Start === \n");
-    fclose(file);
+    element_clear(t1);
+    element_clear(t2);
+    element_clear(out);
 
+    return 1;
+}
+
+
+// Hybrid stream cost per HYBRID_CHUNK record, sealed and opened through one buffer
+// each so memory stays constant. The streams are stateful, so every record is one
+// sample timed here rather than a BenchRun body.
+static int bendmarking_hybrid_stream(BenchReport &report)
+{
     int i;
-    pairing_t pairing;
+    unsigned char key[HYBRID_KEY_LEN] = {0x42};
+    unsigned char header[HYBRID_HEADER_LEN];
+    unsigned char *chunk = (unsigned char *)malloc(HYBRID_CHUNK);
+    unsigned char *record = (unsigned char *)malloc(HYBRID_RECORD_MAX);
+    double *seal_time = (double *)malloc(HYBRID_RENUM * sizeof(double));
+    double *open_time = (double *)malloc(HYBRID_RENUM * sizeof(double));
+    if (!chunk || !record || !seal_time || !open_time)
+    {
+        perror("[FAIL] Memory allocation failed.");
+        exit(1);
+    }
+    memset(chunk, 0x5a, HYBRID_CHUNK);
+
+    HybridStream seal, open;
+    HybridSealInit(seal, key, header);
+    HybridOpenInit(open, key, header);
+
+    // the two streams run in lockstep, record i is opened right after it is sealed
+    for (i = 0; i < HYBRID_RENUM; i++)
+    {
+        uint64_t t0 = BenchNowNs();
+        size_t record_len = HybridSealChunk(seal, chunk, HYBRID_CHUNK, i == HYBRID_RENUM - 1, record);
+        uint64_t t1 = BenchNowNs();
+        long n = HybridOpenChunk(open, record, record_len, chunk);
+        uint64_t t2 = BenchNowNs();
+        seal_time[i] = (double)(t1 - t0);
+        open_time[i] = (double)(t2 - t1);
+        if (n != HYBRID_CHUNK)
+        {
+            printf("[Fail] Hybrid stream record failed to open.\n");
+            exit(1);
+        }
+    }
+    HybridStreamClear(seal);
+    HybridStreamClear(open);
+
+    BenchRecordSamples(report, BENCH_HYBRID_SEAL, "record", seal_time + HYBRID_WARMUP, HYBRID_RENUM - HYBRID_WARMUP);
+    BenchRecordSamples(report, BENCH_HYBRID_OPEN, "record", open_time + HYBRID_WARMUP, HYBRID_RENUM - HYBRID_WARMUP);
+
+    free(chunk);
+    free(record);
+    free(seal_time);
+    free(open_time);
+    return 1;
+}
+
+
+// One WOTS_LEN x (WOTS_W - 1) chain walk per call, hashed three ways:
+// OpenSSL one-shot per step (hash_sha256), the 32-byte fast path per step
+// (hash_sha256_32), and whole chains inside the kernel (hash_sha256_32_chains).
+// Reported per hash.
+static const char *const bendmarking_kernel_names[] = {"scalar", "shani", "avx2"};
+
+// Every 32-byte entry point under kernel against SHA256(), the multi call is one lane
+// short of two full AVX2 groups so the padded tail runs too
+static int bendmarking_hash_kernel_check(Sha256Kernel kernel)
+{
+    uint8_t in[15][WOTS_N], ref[15][WOTS_N], out[15][WOTS_N], block[WOTS_N + 4];
+    uint8_t *out_lanes[15];
+    const uint8_t *in_lanes[15];
+    int steps[15];
+    for (int i = 0; i < 15; i++)
+    {
+        for (int j = 0; j < WOTS_N; j++)
+        {
+            in[i][j] = (uint8_t)(i * 37 + j * 11);
+        }
+        SHA256(in[i], WOTS_N, ref[i]);
+        out_lanes[i] = out[i];
+        in_lanes[i] = in[i];
+        steps[i] = i;
+    }
+
+    hash_sha256_32(out[0], in[0]);
+    int agree = !memcmp(out[0], ref[0], WOTS_N);
+
+    uint32_t index = 0x01020304;
+    memcpy(block, in[1], WOTS_N);
+    block[WOTS_N] = 0x01;
+    block[WOTS_N + 1] = 0x02;
+    block[WOTS_N + 2] = 0x03;
+    block[WOTS_N + 3] = 0x04;
+    SHA256(block, sizeof(block), ref[0]);
+    hash_sha256_32_indexed(out[0], in[1], index);
+    agree = agree && !memcmp(out[0], ref[0], WOTS_N);
+
+    SHA256(in[0], WOTS_N, ref[0]);
+    hash_sha256_32_multi(out_lanes, in_lanes, 15);
+    agree = agree && !memcmp(out, ref, sizeof(ref));
+
+    // chain i is i steps of SHA256() from in[i]
+    for (int i = 0; i < 15; i++)
+    {
+        memcpy(ref[i], in[i], WOTS_N);
+        for (int s = 0; s < steps[i]; s++)
+        {
+            SHA256(ref[i], WOTS_N, ref[i]);
+        }
+        memcpy(out[i], in[i], WOTS_N);
+    }
+    hash_sha256_32_chains(out_lanes, steps, 15);
+    agree = agree && !memcmp(out, ref, sizeof(ref));
+
+    if (!agree)
+    {
+        printf("[Fail] SHA-256 kernel %s disagrees with SHA256().\n", bendmarking_kernel_names[kernel]);
+        exit(1);
+    }
+    return 1;
+}
+
+// Known answer for sk_seed {1} and message {0x12}: the checksum 957 = 0x3BD must
+// sign as digits 3, B, D, so a change to the checksum encoding changes the signature
+static const uint8_t bendmarking_wots_kat_root[WOTS_N] = {
+    0x50, 0x5f, 0x53, 0xa7, 0x57, 0xe8, 0xf4, 0x84, 0xc1, 0xa7, 0xf1, 0x68, 0x36, 0x4e, 0x9e, 0x57,
+    0x26, 0xac, 0x00, 0x17, 0x66, 0x2d, 0xc4, 0xc0, 0x78, 0xf4, 0xb3, 0xbb, 0xab, 0x7d, 0x58, 0x11};
+// SHA256 of the whole signature
+static const uint8_t bendmarking_wots_kat_sig[WOTS_N] = {
+    0x6f, 0x15, 0x2c, 0x2b, 0xd3, 0x76, 0x25, 0xc0, 0x4a, 0xf3, 0x91, 0x21, 0x98, 0x00, 0x87, 0xba,
+    0xb4, 0x90, 0x81, 0x9e, 0x5a, 0x5e, 0xa3, 0xdd, 0xa5, 0xcf, 0x0b, 0x6b, 0xd1, 0x82, 0x82, 0x49};
+
+static int bendmarking_wots_known_answer()
+{
+    uint8_t sk_seed[WOTS_N] = {1};
+    uint8_t message[WOTS_N] = {0x12};
+    uint8_t root[WOTS_N], sig_hash[WOTS_N];
+    uint8_t sig[WOTS_LEN][WOTS_N];
+    wots_keygen_root(root, sk_seed);
+    wots_sign(sig, message, sk_seed);
+    SHA256(&sig[0][0], sizeof(sig), sig_hash);
+    if (memcmp(root, bendmarking_wots_kat_root, WOTS_N) != 0 || memcmp(sig_hash, bendmarking_wots_kat_sig, WOTS_N) != 0)
+    {
+        printf("[Fail] WOTS+ known-answer signature mismatch.\n");
+        exit(1);
+    }
+    return 1;
+}
+
+static int bendmarking_hash_chain(BenchReport &report)
+{
+    Sha256Kernel picked = hash_sha256_kernel();
+
+    uint8_t ref[WOTS_LEN][WOTS_N], fast[WOTS_LEN][WOTS_N], chain[WOTS_LEN][WOTS_N];
+    uint8_t *lanes[WOTS_LEN];
+    int steps[WOTS_LEN];
+    auto reset = [&]() {
+        for (int i = 0; i < WOTS_LEN; i++)
+        {
+            memset(ref[i], i, WOTS_N);
+            memcpy(fast[i], ref[i], WOTS_N);
+            memcpy(chain[i], ref[i], WOTS_N);
+            lanes[i] = chain[i];
+            steps[i] = WOTS_W - 1;
+        }
+    };
+
+    auto oneshot = [&]() {
+        for (int i = 0; i < WOTS_LEN; i++)
+        {
+            for (int j = 0; j < WOTS_W - 1; j++)
+            {
+                hash_sha256(ref[i], WOTS_N, ref[i]);
+            }
+        }
+    };
+    auto fast_path = [&]() {
+        for (int i = 0; i < WOTS_LEN; i++)
+        {
+            for (int j = 0; j < WOTS_W - 1; j++)
+            {
+                hash_sha256_32(fast[i], fast[i]);
+            }
+        }
+    };
+    auto chains = [&]() {
+        hash_sha256_32_chains(lanes, steps, WOTS_LEN);
+    };
+
+    int hashes = WOTS_LEN * (WOTS_W - 1);
+    reset();
+    BenchRun(report, BENCH_HASH_SHA256, "chain walk", oneshot, hashes);
+
+    // every kernel this CPU runs, not only the one picked for it
+    for (int k = 0; k < 3; k++)
+    {
+        if (!hash_sha256_set_kernel((Sha256Kernel)k))
+        {
+            printf("SHA-256 kernel %s not supported, skipped\n", bendmarking_kernel_names[k]);
+            continue;
+        }
+        bendmarking_hash_kernel_check((Sha256Kernel)k);
+
+        // one walk each from the same start must agree
+        reset();
+        oneshot();
+        fast_path();
+        chains();
+        if (memcmp(ref, fast, sizeof(ref)) != 0 || memcmp(ref, chain, sizeof(ref)) != 0)
+        {
+            printf("[Fail] 32-byte hash fast path disagrees with hash_sha256.\n");
+            exit(1);
+        }
+
+        char context[32];
+        snprintf(context, sizeof(context), "chain walk %s", bendmarking_kernel_names[k]);
+        BenchRun(report, BENCH_HASH_SHA256_32, context, fast_path, hashes);
+        BenchRun(report, BENCH_HASH_SHA256_32_CHAINS, context, chains, hashes);
+    }
+    hash_sha256_set_kernel(picked);
+    return 1;
+}
+
+
+int bendmarking(const char *param_file)
+{
+    pairing_ptr pairing;
     element_t P;
     element_t Q, H, R, a, b, c;
     element_t BP;
     element_t a1, b1, c1;
-    double relative_time;
 
-    FILE *fp = fopen("../param/d201.param", "r");
-    if (!fp)
+    pairing = PairingAcquire(param_file);
+    if (!pairing)
     {
-        printf("[Fail] Param file open fail.\n");
         return 1;
     }
-    char param[10240];
-    size_t count = fread(param, 1, sizeof(param), fp);
-    fclose(fp);
-    pairing_init_set_str(pairing, param);
 
     if (!pairing_is_symmetric(pairing))
     {
@@ -94,6 +359,9 @@ int bendmarking()
         printf("[Symmetric] Pairing is an symmetric pairing.\n");
     }
 
+    BenchReport report;
+    report.suite = "bendmarking";
+
     element_init_G1(P, pairing);
     element_random(P);
     element_init_G1(Q, pairing);
@@ -113,417 +381,118 @@ int bendmarking()
     element_random(b1);
     element_init_GT(BP, pairing);
 
-    clock_t start_time, end_time;
-
-    // time_point_mul_G1
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        element_mul_zn(R, P, a);
-    }
-    end_time = clock();
-    double time_point_mul_G1 = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-    if (!file)
-    {
-        perror("[Fail] Bendmarking_output.txt open fail.\n");
-        exit(1);
-    }
-    fprintf(file, "time_point_mul_G1: %.6f ms, ", time_point_mul_G1);
-    relative_time = time_point_mul_G1 / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-    // time_point_add_G1
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        element_add(R, P, Q);
-    }
-    end_time = clock();
-    double time_point_add_G1 = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-    fprintf(file, "time_point_add_G1: %.6f ms, ", time_point_add_G1);
-    relative_time = time_point_add_G1 / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-    // time_add_Zr
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        element_add(c, a, b);
-    }
-    end_time = clock();
-    double time_add_Zr = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-    fprintf(file, "time_add_Zr: %.6f ms, ", time_add_Zr);
-    relative_time = time_add_Zr / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-    // time_del_Zr
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        element_sub(c, a, b);
-    }
-    end_time = clock();
-    double time_del_Zr = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "time_del_Zr: %.6f ms, ", time_del_Zr);
-    relative_time = time_del_Zr / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-    // time_mul_Zr
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        element_mul(c, a, b);
-    }
-    end_time = clock();
-    double time_mul_Zr = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "time_mul_Zr: %.6f ms, ", time_mul_Zr);
-    relative_time = time_mul_Zr / time_point_mul_G1;
-    fprintf(file, "relative_time:%.6f \n", relative_time);
-    fclose(file);
-
-    // time_div_Zr
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        element_div(c, a, b);
-    }
-    end_time = clock();
-    double time_div_Zr = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "time_div_Zr: %.6f ms, ", time_div_Zr);
-    relative_time = time_div_Zr / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-    // time_inv_Zr
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        element_invert(c, a);
-    }
-    end_time = clock();
-    double time_inv_Zr = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "time_inv_Zr: %.6f ms, ", time_inv_Zr);
-    relative_time = time_inv_Zr / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-    // time_mul_GT
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        element_mul(c1, a1, b1);
-    }
-    end_time = clock();
-    double time_mul_GT = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "time_mul_GT: %.6f ms, ", time_mul_GT);
-    relative_time = time_mul_GT / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-    // time_div_GT
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        element_div(c1, a1, b1);
-    }
-    end_time = clock();
-    double time_div_GT = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-    fprintf(file, "time_div_GT: %.6f ms, ", time_div_GT);
-    relative_time = time_div_GT / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-    // time_pow_GT
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        element_pow_zn(c1, a1, b1);
-    }
-    end_time = clock();
-    double time_pow_GT = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "time_pow_GT: %.6f ms, ", time_pow_GT);
-    relative_time = time_pow_GT / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-    // time_BP_G1_G1_GT
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        pairing_apply(BP, Q, H, pairing);
-    }
-    end_time = clock();
-    double time_BP_G1_G1_GT = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "time_BP_G1_G1_GT: %.6f ms, ", time_BP_G1_G1_GT);
-    relative_time = time_BP_G1_G1_GT / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
+    BenchRun(report, BENCH_POINT_MUL_G1, param_file, [&]() { element_mul_zn(R, P, a); });
+    BenchRun(report, BENCH_POINT_ADD_G1, param_file, [&]() { element_add(R, P, Q); });
+    BenchRun(report, BENCH_ADD_ZR, param_file, [&]() { element_add(c, a, b); });
+    BenchRun(report, BENCH_SUB_ZR, param_file, [&]() { element_sub(c, a, b); });
+    BenchRun(report, BENCH_MUL_ZR, param_file, [&]() { element_mul(c, a, b); });
+    BenchRun(report, BENCH_DIV_ZR, param_file, [&]() { element_div(c, a, b); });
+    BenchRun(report, BENCH_INV_ZR, param_file, [&]() { element_invert(c, a); });
+    BenchRun(report, BENCH_MUL_GT, param_file, [&]() { element_mul(c1, a1, b1); });
+    BenchRun(report, BENCH_DIV_GT, param_file, [&]() { element_div(c1, a1, b1); });
+    BenchRun(report, BENCH_POW_GT, param_file, [&]() { element_pow_zn(c1, a1, a); });
+    BenchRun(report, BENCH_PAIRING, param_file, [&]() { pairing_apply(BP, Q, H, pairing); });
 
     element_t g1, g1_inv;
     element_init_G1(g1, pairing);
     element_init_G1(g1_inv, pairing);
-
-    start_time = clock();
     element_random(g1);
+    BenchRun(report, BENCH_POINT_INV_G1, param_file, [&]() { element_invert(g1_inv, g1); });
 
-    for (i = 1; i < RENUM; i++)
-    {
-        // 计算逆元
-    element_invert(g1_inv, g1);
-    }
-    end_time = clock();
-    double time_neg_G1 = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "time_neg_G1: %.6f ms, ", time_neg_G1);
-    relative_time = time_neg_G1 / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-    
-    // time_hash1
-    unsigned char digest[SHA256_DIGEST_LENGTH];
     char Alice[] = "sender.alice@gmail.com";
     element_t user_Alice_Pub;
     element_init_Zr(user_Alice_Pub, pairing);
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        id_to_zr(pairing, Alice, user_Alice_Pub);
-    }
-    end_time = clock();
-    double time_hash1 = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
+    BenchRun(report, BENCH_ID_TO_ZR, param_file, [&]() { id_to_zr(pairing, Alice, user_Alice_Pub); });
 
-    fprintf(file, "time_hash1: %.6f ms, ", time_hash1);
-    relative_time = time_hash1 / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-
-    // time_hash2
     const char* binary_str = "0101010101010101"; // 示例字符串
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        size_t len = strlen(binary_str);
-        unsigned char bytes[len/8 + 1];
-        memset(bytes, 0, sizeof(bytes));
-        
-        for(size_t i = 0; i < len; i++) {
-            if(binary_str[i] == '1') {
-                bytes[i/8] |= (1 << (7 - (i % 8)));
-            }
-        }
-
-        element_t g1;
-        // 2. 将字节数组转换为G1元素
-        element_init_G1(g1, pairing);
-        element_from_bytes(g1, bytes);
-        element_clear(g1);
-    }
-    end_time = clock();
-    double time_hash2 = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "time_hash2: %.6f ms, ", time_hash2);
-    relative_time = time_hash2 / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-
-
-    // time_hash3
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        element_t g1, z;
-        element_init_G2(g1, pairing);
-        element_init_Zr(z, pairing);
-
-        G2_to_Zr_via_hash(z, g1, pairing);
-
-        element_clear(g1);
+    BenchRun(report, BENCH_BYTES_TO_G1, param_file, [&]() {
+        element_t g;
+        binary_string_to_G1(g, binary_str, pairing);
+        element_clear(g);
+    });
+
+    element_t g2, z;
+    element_init_G2(g2, pairing);
+    element_random(g2);
+    BenchRun(report, BENCH_G2_TO_ZR, param_file, [&]() {
+        G2_to_Zr_via_hash(z, g2, pairing);
         element_clear(z);
-    }
-    end_time = clock();
-    double time_hash3 = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
+    });
 
-    fprintf(file, "time_hash3: %.6f ms, ", time_hash3);
-    relative_time = time_hash3 / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-
-
-
-
-    // time_sign_key_gen
+    bendmarking_wots_known_answer();
     uint8_t sk_seed[WOTS_N] = {1};
     uint8_t message[WOTS_N] = {0x12};
 
-    uint8_t pk1[WOTS_LEN][WOTS_N];  
-    uint8_t pk2[WOTS_LEN][WOTS_N];
+    uint8_t pk_root[WOTS_N];
     uint8_t sig[WOTS_LEN][WOTS_N];
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
+    BenchRun(report, BENCH_WOTS_KEYGEN, "wots", [&]() { wots_keygen_root(pk_root, sk_seed); });
+
+    // the message signed is a ciphertext digest
+    ccaCiphertext PCT;
+    element_init_G1(PCT.C1, pairing);
+    element_init_GT(PCT.C2, pairing);
+    element_init_G1(PCT.C3, pairing);
+    element_init_GT(PCT.C4, pairing);
+    element_init_GT(PCT.C5, pairing);
+    element_init_G2(PCT.C6, pairing);
+    element_random(PCT.C1);
+    element_random(PCT.C2);
+    element_random(PCT.C3);
+    element_random(PCT.C4);
+    element_random(PCT.C5);
+    element_random(PCT.C6);
+    // WOTS+ is one-time, every call signs the same digest and gives the same signature
+    ccaCiphertextDigest(PCT, message); // hash to 256bit
+    BenchRun(report, BENCH_WOTS_SIGN, "wots", [&]() { wots_sign(sig, message, sk_seed); });
+
+    int verified = 1;
+    BenchRun(report, BENCH_WOTS_VERIFY, "wots", [&]() { verified &= wots_verify(sig, message, pk_root); });
+    if (!verified)
     {
-        wots_keygen(pk1, sk_seed);
-    //print_hex("Public key (wots_keygen)", pk1, WOTS_LEN * WOTS_N);
+        printf("[Fail] WOTS+ verification failed.\n");
     }
-    end_time = clock();
-    double time_sign_key_gen = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "time_sign_key_gen: %.6f ms, ", time_sign_key_gen);
-    relative_time = time_sign_key_gen / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
 
-
-    // time_sign_gen
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
+    // the cached key must give wots_sign's signature and root
+    WotsKeyCache *cache = new WotsKeyCache;
+    uint8_t cached_root[WOTS_N];
+    uint8_t cached_sig[WOTS_LEN][WOTS_N];
+    BenchRun(report, BENCH_WOTS_KEYGEN, "wots cached", [&]() { wots_keygen_cached(cached_root, sk_seed, *cache); });
+    BenchRun(report, BENCH_WOTS_SIGN, "wots cached", [&]() { wots_sign_cached(cached_sig, message, *cache); });
+    wots_sign(sig, message, sk_seed);
+    if (memcmp(cached_root, pk_root, WOTS_N) != 0 || memcmp(cached_sig, sig, sizeof(sig)) != 0 || !wots_verify(cached_sig, message, cached_root))
     {
-        element_t elements[6];
-        
-        element_init_G1(elements[0], pairing);   // 第1个元素：G1
-        element_init_GT(elements[1], pairing);   // 第2个元素：GT
-        element_init_G1(elements[2], pairing);   // 第3个元素：G1
-        element_init_GT(elements[3], pairing);   // 第4个元素：GT
-        element_init_GT(elements[4], pairing);   // 第5个元素：GT
-        element_init_G1(elements[5], pairing);   // 第6个元素：G1
-
-        element_random(elements[0]);
-        element_random(elements[1]);
-        element_random(elements[2]);
-        element_random(elements[3]);
-        element_random(elements[4]);
-        element_random(elements[5]);
-
-        size_t total_len = 0;
-        for (int i = 0; i < 6; i++) {
-            total_len += element_length_in_bytes(elements[i]);
-        }
-
-        // 
-        unsigned char *buffer = (unsigned char *)malloc(total_len);
-        if (!buffer) {
-            perror("[FAIL] Memory allocation failed.");
-            exit(1);
-        }
-
-        // 
-        size_t offset = 0;
-        for (int i = 0; i < 6; i++) {
-            int len = element_to_bytes(buffer + offset, elements[i]);
-            if (len != element_length_in_bytes(elements[i])) {
-                fprintf(stderr, "Serialization error: Element %d\n", i);
-                free(buffer);
-                exit(1);
-            }
-            offset += len;
-        }
-        SHA256(buffer, total_len, message); // hash to 256bit
-        wots_sign(sig, message, sk_seed);
-        free(buffer);
-        element_clear(elements[0]);
-        element_clear(elements[1]);
-        element_clear(elements[2]);
-        element_clear(elements[3]);
-        element_clear(elements[4]);
-        element_clear(elements[5]);
-    }
-    end_time = clock();
-    double time_sign_gen = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "time_sign_gen: %.6f ms, ", time_sign_gen);
-    relative_time = time_sign_gen / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
-
-    // time_sign_verify
-    start_time = clock();
-    for (i = 1; i < RENUM; i++)
-    {
-        wots_pk_from_sig(pk2, sig, message);
-        //print_hex("Recovered public key (wots_pk_from_sig)", pk2, WOTS_LEN * WOTS_N);
-
-        int receiversuccess = 1;
-        for (int i = 0; i < WOTS_LEN; i++) {
-            if (memcmp(pk1[i], pk2[i], WOTS_N) != 0) {
-                receiversuccess = 0;
-                break;
-            }
-        }
-        //printf("WOTS+ verification %s\n", receiversuccess ? "passed" : "failed");
+        printf("[Fail] Cached WOTS+ key disagrees with wots_sign.\n");
+        exit(1);
     }
-    end_time = clock();
-    double time_sign_verify = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    file = fopen("bendmarking_output.txt", "a");
-
-    fprintf(file, "ttime_sign_verify: %.6f ms, ", time_sign_verify);
-    relative_time = time_sign_verify / time_point_mul_G1;
-    fprintf(file, "relative_time: %.6f \n", relative_time);
-    fclose(file);
-
+    memset(cache, 0, sizeof(WotsKeyCache));
+    delete cache;
 
+    // ccaDec2 / SenderDec pairing cost, before and after element_prod_pairing
+    bendmarking_prod_pairing(report, "../param/a.param");
+    bendmarking_prod_pairing(report, "../param/d201.param");
+    bendmarking_hybrid_stream(report);
+    bendmarking_hash_chain(report);
 
-    file = fopen("bendmarking_output.txt", "a");
-    if (!file)
+    BenchPrint(report);
+    if (!BenchWrite(report, "bendmarking_output"))
     {
-        perror("[Fail] Bendmarking_output.txt open fail.\n");
         exit(1);
     }
-    fprintf(file, "=== Bendmarking Test End === \n");
-    fclose(file);
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
 
     // clear memory
+    element_clear(PCT.C1);
+    element_clear(PCT.C2);
+    element_clear(PCT.C3);
+    element_clear(PCT.C4);
+    element_clear(PCT.C5);
+    element_clear(PCT.C6);
+    element_clear(user_Alice_Pub);
+    element_clear(g1);
+    element_clear(g1_inv);
+    element_clear(g2);
     element_clear(P);
     element_clear(Q);
+    element_clear(H);
     element_clear(R);
     element_clear(a);
     element_clear(b);
@@ -533,7 +502,5 @@ int bendmarking()
     element_clear(c1);
     element_clear(BP);
 
-    pairing_clear(pairing);
-
     return 1;
 }
\ No newline at end of file
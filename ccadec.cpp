@@ -12,53 +12,56 @@
 #include "pbc.h"
 #include "ccastruct.h"
 #include "cpastruct.h"
+#include "precompute.h"
+#include "scratch.h"
+#include "ccamap.h"
+#include "trace.h"
+#include <string.h>
 
 // Dec1 decryption function
-void ccaDec1(pairing_t pairing, UserPrivateKey User_Priv, ccaRj rj, element_t& X)
+void ccaDec1(pairing_t pairing, UserPrivateKey &User_Priv, ccaRj &rj, element_t& X)
 {
-    element_t temp1, temp2;
-    element_init_GT(temp1, pairing);
-    element_init_GT(temp2, pairing);
+    TRACE_FUNCTION("ccaDec1");
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
 
     
-    pairing_apply(temp1, rj.u, User_Priv.K, pairing);
-    element_pow_zn(temp2, rj.v, User_Priv.r);
+    TRACE_OP(TRACE_PAIRING, pairing_apply(temp1, rj.u, User_Priv.K, pairing));
+    TRACE_OP(TRACE_POW_GT, element_pow_zn(temp2, rj.v, User_Priv.r));
     element_mul(X, temp1, temp2);
     element_mul(X, X, rj.w);
 
 
-    element_clear(temp1);
-    element_clear(temp2);
 
     //cout << "Dec1 decryption function: X =" << endl;
-
 }
 
 // Dec2 decryption function
-void ccaDec2(pairing_t pairing, UserPrivateKey User_Priv, ccaReCiphertext RCT, TimeTrapDoor St , ccaRj rj, element_t X, element_t& PT_Bob)
+void ccaDec2(pairing_t pairing, UserPrivateKey &User_Priv, ccaReCiphertext &RCT, TimeTrapDoor &St , ccaRj &rj, element_t X, element_t& PT_Bob)
 {
-    element_t temp1, temp2, temp3, temp4;
-    element_init_GT(temp1, pairing);
-    element_init_GT(temp2, pairing);
-    element_init_GT(temp3, pairing);
-    element_init_G1(temp4, pairing);
-
-    pairing_apply(temp1, RCT.C1, St.K, pairing);
-    element_pow_zn(temp2, RCT.C2, St.r);
+    TRACE_FUNCTION("ccaDec2");
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
+    element_ptr temp3 = frame.G1();
+    element_ptr temp4 = frame.G2();
+
+    // e(C1, St.K) / e(C3, C6 + RK2) = e(C1, St.K) * e(-C3, C6 + RK2)
+    TRACE_STAGE("pairings");
+    element_neg(temp3, RCT.C3);
+    element_add(temp4, RCT.C6, RCT.RK2);
+    TRACE_OP(TRACE_PAIRING_PROD, PairingProd2(temp1, RCT.C1, St.K, temp3, temp4, pairing));
+
+    TRACE_STAGE("C2^r");
+    TRACE_OP(TRACE_POW_GT, element_pow_zn(temp2, RCT.C2, St.r));
+    TRACE_STAGE("GT mul");
     element_mul(PT_Bob, temp1, temp2);
     element_mul(PT_Bob, PT_Bob, RCT.C32);
     element_mul(PT_Bob, PT_Bob, RCT.C4);
     element_mul(PT_Bob, PT_Bob, RCT.C5);
     element_div(PT_Bob, PT_Bob, X);
 
-    element_add(temp4, RCT.C6, RCT.RK2);
-    pairing_apply(temp3, RCT.C3, temp4, pairing);
-    element_div(PT_Bob, PT_Bob, temp3);
-
-    element_clear(temp1);
-    element_clear(temp2);
-    element_clear(temp3);
-    element_clear(temp4);
 
     // cout << "PT_Bob seccess:" << endl;
     // element_printf("PT_Bob = %B\n", PT_Bob); 
@@ -67,38 +70,138 @@ void ccaDec2(pairing_t pairing, UserPrivateKey User_Priv, ccaReCiphertext RCT, T
 
 
 // Sender decryption function
-void ccaSenderDec(pairing_t pairing, pkg_params pkg_params, ts_params ts_params, UserPrivateKey User_Alice_Priv, TimeTrapDoor St, ccaCiphertext PCT, element_t &PT_Alice)
+void ccaSenderDec(pairing_t pairing, pkg_params &pkg_params, ts_params &ts_params, UserPrivateKey &User_Alice_Priv, TimeTrapDoor &St, ccaCiphertext &PCT, element_t &PT_Alice)
 {
-    element_t temp1, temp2, temp3, temp4;
-    element_init_GT(temp1, pairing);
-    element_init_GT(temp2, pairing);
-    element_init_GT(temp3, pairing);
-    element_init_GT(temp4, pairing);
-
+    TRACE_FUNCTION("ccaSenderDec");
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
 
-    pairing_apply(temp1, PCT.C1, St.K, pairing);
-    element_pow_zn(temp2, PCT.C2, St.r);
+    // e(C1, St.K) * e(C3, K)
+    TRACE_STAGE("pairings");
+    TRACE_OP(TRACE_PAIRING_PROD, PairingProd2(temp1, PCT.C1, St.K, PCT.C3, User_Alice_Priv.K, pairing));
 
-    pairing_apply(temp3, PCT.C3, User_Alice_Priv.K, pairing);
-    //element_pow_zn(temp4, PCT.C4, User_Alice_Priv.r);
-
-
-    //element_mul(PT_Alice, PCT.C5, temp1);
-    //element_mul(PT_Alice, PT_Alice, temp2);
-    //element_mul(PT_Alice, PCT.C5, temp3);
-    //element_mul(PT_Alice, PT_Alice,temp4);
+    TRACE_STAGE("C2^r");
+    TRACE_OP(TRACE_POW_GT, element_pow_zn(temp2, PCT.C2, St.r));
     
+    TRACE_STAGE("GT mul");
     element_mul(PT_Alice, temp1, temp2);
-    element_mul(PT_Alice, PT_Alice, temp3);
     element_mul(PT_Alice, PT_Alice, PCT.C4);
     element_mul(PT_Alice, PT_Alice, PCT.C5);
 
-    element_clear(temp1);
-    element_clear(temp2);
-    element_clear(temp3);
-    element_clear(temp4);
 
     //element_printf("PT_Alice in dec = %B\n", PT_Alice); 
     //cout << "Sender decryption sueecss:" << endl;
     
-}
\ No newline at end of file
+}
+
+
+// Dec1 with a prepared key
+void ccaDec1(pairing_t pairing, PreparedUserPrivateKey &User_Priv, ccaRj &rj, element_t& X)
+{
+    TRACE_FUNCTION("ccaDec1");
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
+
+    TRACE_OP(TRACE_PAIRING, pairing_pp_apply(temp1, rj.u, User_Priv.K));
+    TRACE_OP(TRACE_POW_GT, element_pow_zn(temp2, rj.v, User_Priv.r));
+    element_mul(X, temp1, temp2);
+    element_mul(X, X, rj.w);
+}
+
+// Dec2 with a prepared time trapdoor, e(C3, C6 + RK2) has no fixed operand
+void ccaDec2(pairing_t pairing, PreparedUserPrivateKey &User_Priv, ccaReCiphertext &RCT, PreparedTimeTrapDoor &St , ccaRj &rj, element_t X, element_t& PT_Bob)
+{
+    TRACE_FUNCTION("ccaDec2");
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
+    element_ptr temp3 = frame.GT();
+    element_ptr temp4 = frame.G2();
+
+    TRACE_STAGE("e(C1, St.K)");
+    TRACE_OP(TRACE_PAIRING, pairing_pp_apply(temp1, RCT.C1, St.K));
+    TRACE_STAGE("C2^r");
+    TRACE_OP(TRACE_POW_GT, element_pow_zn(temp2, RCT.C2, St.r));
+    TRACE_STAGE("GT mul");
+    element_mul(PT_Bob, temp1, temp2);
+    element_mul(PT_Bob, PT_Bob, RCT.C32);
+    element_mul(PT_Bob, PT_Bob, RCT.C4);
+    element_mul(PT_Bob, PT_Bob, RCT.C5);
+    element_div(PT_Bob, PT_Bob, X);
+
+    TRACE_STAGE("e(C3, C6 + RK2)");
+    element_add(temp4, RCT.C6, RCT.RK2);
+    TRACE_OP(TRACE_PAIRING, pairing_apply(temp3, RCT.C3, temp4, pairing));
+    element_div(PT_Bob, PT_Bob, temp3);
+}
+
+// Sender decryption with prepared keys
+void ccaSenderDec(pairing_t pairing, PreparedUserPrivateKey &User_Alice_Priv, PreparedTimeTrapDoor &St, ccaCiphertext &PCT, element_t &PT_Alice)
+{
+    TRACE_FUNCTION("ccaSenderDec");
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
+    element_ptr temp3 = frame.GT();
+
+    TRACE_STAGE("e(C1, St.K)");
+    TRACE_OP(TRACE_PAIRING, pairing_pp_apply(temp1, PCT.C1, St.K));
+    TRACE_STAGE("C2^r");
+    TRACE_OP(TRACE_POW_GT, element_pow_zn(temp2, PCT.C2, St.r));
+
+    TRACE_STAGE("e(C3, K)");
+    TRACE_OP(TRACE_PAIRING, pairing_pp_apply(temp3, PCT.C3, User_Alice_Priv.K));
+
+    TRACE_STAGE("GT mul");
+    element_mul(PT_Alice, temp1, temp2);
+    element_mul(PT_Alice, PT_Alice, temp3);
+    element_mul(PT_Alice, PT_Alice, PCT.C4);
+    element_mul(PT_Alice, PT_Alice, PCT.C5);
+}
+
+
+// Shallow ccaReCiphertext over the stored PCT and a delta, shares every limb and is never cleared
+static void cca_delta_view(ccaCiphertext &PCT, ccaReDelta &Delta, ccaReCiphertext &RCT)
+{
+    RCT.C1[0] = *PCT.C1;
+    RCT.C2[0] = *PCT.C2;
+    RCT.C3[0] = *PCT.C3;
+    RCT.C4[0] = *PCT.C4;
+    RCT.C5[0] = *PCT.C5;
+    RCT.C6[0] = *PCT.C6;
+    RCT.RK2[0] = *Delta.RK2;
+    RCT.C32[0] = *Delta.C32;
+}
+
+// Dec2 on a re-encryption delta, 0 if Delta was not made from PCT
+int ccaDec2Delta(pairing_t pairing, UserPrivateKey &User_Priv, ccaCiphertext &PCT, ccaReDelta &Delta, TimeTrapDoor &St , ccaRj &rj, element_t X, element_t& PT_Bob)
+{
+    unsigned char ref[CCA_REF_LEN];
+    ccaCiphertextDigest(PCT, ref);
+    if (memcmp(ref, Delta.ref, CCA_REF_LEN))
+    {
+        return 0;
+    }
+
+    ccaReCiphertext RCT;
+    cca_delta_view(PCT, Delta, RCT);
+    ccaDec2(pairing, User_Priv, RCT, St, rj, X, PT_Bob);
+    return 1;
+}
+
+int ccaDec2Delta(pairing_t pairing, PreparedUserPrivateKey &User_Priv, ccaCiphertext &PCT, ccaReDelta &Delta, PreparedTimeTrapDoor &St , ccaRj &rj, element_t X, element_t& PT_Bob)
+{
+    unsigned char ref[CCA_REF_LEN];
+    ccaCiphertextDigest(PCT, ref);
+    if (memcmp(ref, Delta.ref, CCA_REF_LEN))
+    {
+        return 0;
+    }
+
+    ccaReCiphertext RCT;
+    cca_delta_view(PCT, Delta, RCT);
+    ccaDec2(pairing, User_Priv, RCT, St, rj, X, PT_Bob);
+    return 1;
+}
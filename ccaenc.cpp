@@ -13,59 +13,60 @@
 #include "ccaenc.h"
 #include "ccastruct.h"
 #include "cpastruct.h"
+#include "scratch.h"
+#include "ccamap.h"
+#include "trace.h"
 
 // Encryption function
-void ccaEnc(pairing_t pairing, pkg_params pkg_params, ts_params ts_params, element_t user_Alice_Pub, UserPrivateKey User_Alice_Priv, element_t Time_Pub, element_t vk, element_t PT, ccaCiphertext &PCT)
+void ccaEnc(pairing_t pairing, pkg_params &pkg_params, ts_params &ts_params, element_t user_Alice_Pub, UserPrivateKey &User_Alice_Priv, element_t Time_Pub, element_t vk, element_t PT, ccaCiphertext &PCT)
 {
+    TRACE_FUNCTION("ccaEnc");
+    ScratchFrame frame(pairing);
 
-    element_t k1, k2;
-    element_t temp1, temp2, temp3, temp4, temp5, temp6, temp7;
-
-    element_init_Zr(k1, pairing);
-    element_init_Zr(k2, pairing);
+    element_ptr k1 = frame.Zr();
+    element_ptr k2 = frame.Zr();
     element_random(k1);
     element_random(k2);
 
-    element_init_Zr(temp1, pairing);
-    element_init_G1(temp2, pairing);
-    element_init_GT(temp3, pairing);
-    element_init_Zr(temp4, pairing);
-    element_init_G1(temp5, pairing);
-    element_init_GT(temp6, pairing);
-    element_init_G1(temp7, pairing);
+    element_ptr temp1 = frame.Zr();
+    element_ptr temp2 = frame.G1();
+    element_ptr temp3 = frame.GT();
+    element_ptr temp4 = frame.Zr();
+    element_ptr temp5 = frame.G1();
+    element_ptr temp6 = frame.GT();
 
     // C1
+    TRACE_STAGE("C1");
     element_mul(temp1, k1, Time_Pub);
-    element_neg(PCT.C1, ts_params.g);
-    element_pow_zn(PCT.C1, PCT.C1, temp1);
-    element_pow_zn(temp2, ts_params.g1, k1);
+    element_neg(temp1, temp1);
+    TRACE_OP(TRACE_POW_G1, element_pp_pow_zn(PCT.C1, temp1, ts_params.g_pp));
+    TRACE_OP(TRACE_POW_G1, element_pp_pow_zn(temp2, k1, ts_params.g1_pp));
     element_add(PCT.C1, PCT.C1, temp2);
 
     // C2
-    element_pow_zn(PCT.C2, ts_params.e_g_g, k1);
+    TRACE_STAGE("C2");
+    TRACE_OP(TRACE_POW_GT, element_pp_pow_zn(PCT.C2, k1, ts_params.e_g_g_pp));
 
     // C3
+    TRACE_STAGE("C3");
     element_mul(temp4, k2, user_Alice_Pub);
-    element_neg(PCT.C3, pkg_params.g);
-    element_pow_zn(PCT.C3, PCT.C3, temp4);
-    element_pow_zn(temp5, pkg_params.g1, k2);
+    element_neg(temp4, temp4);
+    TRACE_OP(TRACE_POW_G1, element_pp_pow_zn(PCT.C3, temp4, pkg_params.g_pp));
+    TRACE_OP(TRACE_POW_G1, element_pp_pow_zn(temp5, k2, pkg_params.g1_pp));
     element_add(PCT.C3, PCT.C3, temp5);
 
 
     // C4
-    element_pow_zn(PCT.C4, pkg_params.e_g_g, k2);   // {e(g,g)^k1}^{k2}
-    element_pow_zn(PCT.C4, PCT.C4, User_Alice_Priv.r);
-    
-    //element_mul(temp7, k2, User_Alice_Priv.r);
-    //element_pow_zn(PCT.C4, pkg_params.e_g_g, temp7);   // fail
+    TRACE_STAGE("C4");
+    element_mul(temp4, k2, User_Alice_Priv.r);
+    TRACE_OP(TRACE_POW_GT, element_pp_pow_zn(PCT.C4, temp4, pkg_params.e_g_g_pp));   // e(g,g)^{k2 r}
 
 
     // C5
-    element_invert(temp3, ts_params.e_g_h);
-    element_pow_zn(temp3, temp3, k1);
+    TRACE_STAGE("C5");
+    TRACE_OP(TRACE_POW_GT, element_pp_pow_zn(temp3, k1, ts_params.e_g_h_inv_pp));
 
-    element_invert(temp6, pkg_params.e_g_h);
-    element_pow_zn(temp6, temp6, k2);
+    TRACE_OP(TRACE_POW_GT, element_pp_pow_zn(temp6, k2, pkg_params.e_g_h_inv_pp));
 
     //element_mul(PCT.C5, PT, temp3);
     //element_mul(PCT.C5, PT, temp6);
@@ -75,44 +76,46 @@ void ccaEnc(pairing_t pairing, pkg_params pkg_params, ts_params ts_params, eleme
     element_mul(PCT.C5, PCT.C5, temp6);
 
     // C6
-    element_pow_zn(PCT.C6, pkg_params.g, vk);
+    TRACE_STAGE("C6");
+    TRACE_OP(TRACE_POW_G2, element_pp_pow_zn(PCT.C6, vk, pkg_params.g2_pp));
     
 
-    element_clear(k1);
-    element_clear(k2);
-    element_clear(temp1);
-    element_clear(temp2);
-    element_clear(temp3);
-    element_clear(temp4);
-    element_clear(temp5);
-    element_clear(temp6);
-    element_clear(temp7);
 
     // element_clear(result);
-
-
 }
 
 
 // Re-Encryption function
-void ccaReEnc(pairing_t pairing, ccaCiphertext PCT, element_t rk, pkg_params pkg_params, element_t vk, ccaReCiphertext &RCT)
+// RK2 and C32, the only re-encryption components that depend on rk
+static void cca_reenc_components(pairing_t pairing, ccaCiphertext &PCT, element_t rk, pkg_params &pkg_params, element_t vk, element_t RK2, element_t C32)
 {
+    TRACE_FUNCTION("ccaReEnc");
+    ScratchFrame frame(pairing);
 
-    element_t RK1, r, temp;
-    element_init_G1(RK1, pairing);
-    element_init_Zr(r, pairing);
-    element_init_Zr(temp, pairing);
+    element_ptr RK1 = frame.G2();
+    element_ptr r = frame.Zr();
+    element_ptr temp = frame.Zr();
     element_random(r);
 
     // RK1
+    TRACE_STAGE("RK1");
     element_add(temp, r, vk);
-    element_pow_zn(RK1, pkg_params.g, temp);
+    TRACE_OP(TRACE_POW_G2, element_pp_pow_zn(RK1, temp, pkg_params.g2_pp));
     element_add(RK1, RK1, rk);
 
     // RK2
-    element_pow_zn(RCT.RK2, pkg_params.g, r);
+    TRACE_STAGE("RK2");
+    TRACE_OP(TRACE_POW_G2, element_pp_pow_zn(RK2, r, pkg_params.g2_pp));
+
+    //  C32
+    TRACE_STAGE("C32");
+    TRACE_OP(TRACE_PAIRING, pairing_apply(C32, PCT.C3, RK1, pairing));
+}
+
+void ccaReEnc(pairing_t pairing, ccaCiphertext &PCT, element_t rk, pkg_params &pkg_params, element_t vk, ccaReCiphertext &RCT)
+{
+    cca_reenc_components(pairing, PCT, rk, pkg_params, vk, RCT.RK2, RCT.C32);
 
- 
     //  RCT.C1 = PCT.C1;
     element_set(RCT.C1, PCT.C1);
 
@@ -131,13 +134,102 @@ void ccaReEnc(pairing_t pairing, ccaCiphertext PCT, element_t rk, pkg_params pkg
     //  RCT.C5 = PCT.C5;
     element_set(RCT.C6, PCT.C6);
 
-    //  RCT.C32
-    pairing_apply(RCT.C32, PCT.C3, RK1, pairing);
-
     //cout << "代理ReEnc Success" << endl;
+}
+
+// Header-only re-encryption, C1..C6 stay with the stored PCT
+void ccaReEncDelta(pairing_t pairing, ccaCiphertext &PCT, element_t rk, pkg_params &pkg_params, element_t vk, ccaReDelta &Delta)
+{
+    cca_reenc_components(pairing, PCT, rk, pkg_params, vk, Delta.RK2, Delta.C32);
+    ccaCiphertextDigest(PCT, Delta.ref);
+}
 
-    element_clear(RK1);
-    element_clear(r);
-    element_clear(temp);
 
-}
\ No newline at end of file
+// Per-batch state, g and rk with pairing preprocessing (symmetric pairings only)
+typedef struct cca_reenc_batch
+{
+    int prepared;
+    pairing_pp_t g, rk;
+} cca_reenc_batch;
+
+// A fresh r per ciphertext is kept: a shared r would give every output the same RK2 and link
+// them, so RK1 is not amortised. On a symmetric pairing
+//   C32 = e(C3, g^(r+vk) + rk) = e(g, C3)^(r+vk) * e(rk, C3)
+// costs two preprocessed pairings and a GT power instead of a full pairing and a G1 power.
+// Preprocessing g and rk costs about three pairings on a.param, so small batches and asymmetric
+// pairings (where preprocessing loses to the full pairing) take ccaReEnc's path.
+static void cca_reenc_batch_init(pairing_t pairing, int ciphertext_number, element_t rk, pkg_params &pkg_params, cca_reenc_batch &batch)
+{
+    batch.prepared = pairing_is_symmetric(pairing) && ciphertext_number >= CCA_REENC_PP_MIN;
+    if (batch.prepared)
+    {
+        pairing_pp_init(batch.g, pkg_params.g2, pairing);
+        pairing_pp_init(batch.rk, rk, pairing);
+    }
+}
+
+static void cca_reenc_batch_clear(cca_reenc_batch &batch)
+{
+    if (batch.prepared)
+    {
+        pairing_pp_clear(batch.g);
+        pairing_pp_clear(batch.rk);
+    }
+}
+
+static void cca_reenc_batch_components(pairing_t pairing, cca_reenc_batch &batch, ccaCiphertext &PCT, element_t rk, pkg_params &pkg_params, element_t vk, element_t RK2, element_t C32)
+{
+    if (!batch.prepared)
+    {
+        cca_reenc_components(pairing, PCT, rk, pkg_params, vk, RK2, C32);
+        return;
+    }
+
+    TRACE_FUNCTION("ccaReEncBatch");
+    ScratchFrame frame(pairing);
+    element_ptr r = frame.Zr();
+    element_ptr s = frame.Zr();
+    element_ptr temp = frame.GT();
+    element_random(r);
+    element_add(s, r, vk);
+
+    // RK2
+    TRACE_STAGE("RK2");
+    TRACE_OP(TRACE_POW_G2, element_pp_pow_zn(RK2, r, pkg_params.g2_pp));
+
+    //  C32
+    TRACE_STAGE("C32");
+    TRACE_OP(TRACE_PAIRING, pairing_pp_apply(C32, PCT.C3, batch.g));
+    TRACE_OP(TRACE_POW_GT, element_pow_zn(C32, C32, s));
+    TRACE_OP(TRACE_PAIRING, pairing_pp_apply(temp, PCT.C3, batch.rk));
+    element_mul(C32, C32, temp);
+}
+
+void ccaReEncBatch(pairing_t pairing, ccaCiphertext PCT[], int ciphertext_number, element_t rk, pkg_params &pkg_params, element_t vk[], ccaReCiphertext RCT[])
+{
+    cca_reenc_batch batch;
+    cca_reenc_batch_init(pairing, ciphertext_number, rk, pkg_params, batch);
+    for (int i = 0; i < ciphertext_number; i++)
+    {
+        cca_reenc_batch_components(pairing, batch, PCT[i], rk, pkg_params, vk[i], RCT[i].RK2, RCT[i].C32);
+        element_set(RCT[i].C1, PCT[i].C1);
+        element_set(RCT[i].C2, PCT[i].C2);
+        element_set(RCT[i].C3, PCT[i].C3);
+        element_set(RCT[i].C4, PCT[i].C4);
+        element_set(RCT[i].C5, PCT[i].C5);
+        element_set(RCT[i].C6, PCT[i].C6);
+    }
+    cca_reenc_batch_clear(batch);
+}
+
+void ccaReEncDeltaBatch(pairing_t pairing, ccaCiphertext PCT[], int ciphertext_number, element_t rk, pkg_params &pkg_params, element_t vk[], ccaReDelta Delta[])
+{
+    cca_reenc_batch batch;
+    cca_reenc_batch_init(pairing, ciphertext_number, rk, pkg_params, batch);
+    for (int i = 0; i < ciphertext_number; i++)
+    {
+        cca_reenc_batch_components(pairing, batch, PCT[i], rk, pkg_params, vk[i], Delta[i].RK2, Delta[i].C32);
+        ccaCiphertextDigest(PCT[i], Delta[i].ref);
+    }
+    cca_reenc_batch_clear(batch);
+}
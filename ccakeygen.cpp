@@ -12,22 +12,25 @@
 #include "cpastruct.h"
 #include "ccastruct.h"
 #include "ccakeygen.h"
+#include "scratch.h"
+#include "trace.h"
 
 
 // User private key generation function
-void ccaPrivatekeyGen(pairing_t pairing, element_t pkg_priv, pkg_params pkg_params, element_t user_Alice_Pub, UserPrivateKey &privatekey)
+void ccaPrivatekeyGen(pairing_t pairing, element_t pkg_priv, pkg_params &pkg_params, element_t user_Alice_Pub, UserPrivateKey &privatekey)
 {
-    element_t diff, inv;
+    TRACE_FUNCTION("ccaPrivatekeyGen");
+    ScratchFrame frame(pairing);
     element_random(privatekey.r);
-    element_init_Zr(diff, pairing);
-    element_init_Zr(inv, pairing);
+    element_ptr diff = frame.Zr();
+    element_ptr inv = frame.Zr();
 
     element_sub(diff, pkg_priv, user_Alice_Pub);
     element_invert(inv, diff);
-    element_neg(privatekey.K, pkg_params.g);
-    element_pow_zn(privatekey.K, privatekey.K, privatekey.r);
+    TRACE_OP(TRACE_POW_G2, element_pp_pow_zn(privatekey.K, privatekey.r, pkg_params.g2_pp));
+    element_neg(privatekey.K, privatekey.K);
     element_add(privatekey.K, privatekey.K, pkg_params.h);
-    element_pow_zn(privatekey.K, privatekey.K, inv);
+    TRACE_OP(TRACE_POW_G2, element_pow_zn(privatekey.K, privatekey.K, inv));
 
     // if (inv == 0)
     // {
@@ -40,76 +43,152 @@ void ccaPrivatekeyGen(pairing_t pairing, element_t pkg_priv, pkg_params pkg_para
     // }
     //element_printf("privatekey.r = %B\n", privatekey.r);
     //element_printf("privatekey.K = %B\n", privatekey.K);
-
-    element_clear(diff);
-    element_clear(inv);
 }
 
 // TimeTrapDoor generation function
-void ccaTimeTrapDoorGen(pairing_t pairing, element_t ts_priv, ts_params ts_params, element_t Time_Pub, TimeTrapDoor &Time_St)
+void ccaTimeTrapDoorGen(pairing_t pairing, element_t ts_priv, ts_params &ts_params, element_t Time_Pub, TimeTrapDoor &Time_St)
 {
-    element_t diff, inv;            
+    TRACE_FUNCTION("ccaTimeTrapDoorGen");
+    ScratchFrame frame(pairing);
     element_random(Time_St.r); 
-    element_init_Zr(diff, pairing);
-    element_init_Zr(inv, pairing);
+    element_ptr diff = frame.Zr();
+    element_ptr inv = frame.Zr();
     
     element_sub(diff, ts_priv, Time_Pub);
     element_invert(inv, diff);
-    element_neg(Time_St.K, ts_params.g);
-    element_pow_zn(Time_St.K, Time_St.K, Time_St.r);
+    TRACE_OP(TRACE_POW_G2, element_pp_pow_zn(Time_St.K, Time_St.r, ts_params.g2_pp));
+    element_neg(Time_St.K, Time_St.K);
     element_add(Time_St.K, Time_St.K, ts_params.h);
-    element_pow_zn(Time_St.K, Time_St.K, inv);
-
-    element_clear(diff);
-    element_clear(inv);
+    TRACE_OP(TRACE_POW_G2, element_pow_zn(Time_St.K, Time_St.K, inv));
 }
 
 
 
 
 // RK, X generation function
-void ccaRkGen(pairing_t pairing, pkg_params pkg_params, element_t user_Alice_Pub, UserPrivateKey User_Alice_Priv, ccaCiphertext PCT, element_t &rk, element_t &X)
+void ccaRkGen(pairing_t pairing, UserPrivateKey &User_Alice_Priv, ccaCiphertext &PCT, element_t &rk, element_t &X)
 {
-    element_t Q, temp;
-    element_init_G1(Q, pairing);
-    element_init_G1(temp, pairing);
+    TRACE_FUNCTION("ccaRkGen");
+    ScratchFrame frame(pairing);
+    element_ptr Q = frame.G2();
+    element_ptr temp = frame.G2();
     
     element_random(Q);
 
-    element_pow_zn(temp, Q, User_Alice_Priv.r);
+    TRACE_OP(TRACE_POW_G2, element_pow_zn(temp, Q, User_Alice_Priv.r));
     element_add(rk, temp, User_Alice_Priv.K);
-    pairing_apply(X, PCT.C3, temp, pairing);
-
-    element_clear(Q);
-    element_clear(temp);
+    TRACE_OP(TRACE_PAIRING, pairing_apply(X, PCT.C3, temp, pairing));
 
     //cout << "RK, X generation function:" << endl;
 }
 
+// Smallest batch for which preprocessing Q^r pays off, pairing_pp_init costs about 1.5 pairings on a.param
+#define CCA_RKGEN_PP_MIN 4
+
+// Batched RK, X generation, one Q^r for all of PCT[]
+void ccaRkGenBatch(pairing_t pairing, UserPrivateKey &User_Alice_Priv, ccaCiphertext PCT[], int ciphertext_number, element_t rk, element_t X[])
+{
+    TRACE_FUNCTION("ccaRkGenBatch");
+    ScratchFrame frame(pairing);
+    element_ptr Q = frame.G2();
+    element_ptr temp = frame.G2();
+
+    element_random(Q);
+
+    TRACE_STAGE("rk");
+    TRACE_OP(TRACE_POW_G2, element_pow_zn(temp, Q, User_Alice_Priv.r));
+    element_add(rk, temp, User_Alice_Priv.K);
+
+    // X[i] = e(C3_i, Q^r), Q^r can only be preprocessed as the first argument on a symmetric pairing
+    TRACE_STAGE("X");
+    if (pairing_is_symmetric(pairing) && ciphertext_number >= CCA_RKGEN_PP_MIN)
+    {
+        pairing_pp_t temp_pp;
+        pairing_pp_init(temp_pp, temp, pairing);
+        for (int i = 0; i < ciphertext_number; i++)
+        {
+            TRACE_OP(TRACE_PAIRING, pairing_pp_apply(X[i], PCT[i].C3, temp_pp));
+        }
+        pairing_pp_clear(temp_pp);
+    }
+    else
+    {
+        for (int i = 0; i < ciphertext_number; i++)
+        {
+            TRACE_OP(TRACE_PAIRING, pairing_apply(X[i], PCT[i].C3, temp, pairing));
+        }
+    }
+}
+
 // Rj generation function
-void ccaRjGen(pairing_t pairing, pkg_params pkg_params, UserPrivateKey User_Alice_Priv, element_t user_Pub, element_t rk, element_t X, element_t k3, ccaRj &rj)
+void ccaRjGen(pairing_t pairing, pkg_params &pkg_params, element_t user_Pub, element_t X, element_t k3, ccaRj &rj)
 {
-    element_t temp1, temp2;
-    element_init_Zr(temp1, pairing);
-    element_init_G1(temp2, pairing);
+    TRACE_FUNCTION("ccaRjGen");
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.Zr();
+    element_ptr temp2 = frame.G1();
 
     // u
+    TRACE_STAGE("u");
     element_mul(temp1, k3, user_Pub);
-    element_neg(rj.u, pkg_params.g);
-    element_pow_zn(rj.u, rj.u, temp1);
-    element_pow_zn(temp2, pkg_params.g1, k3);
+    element_neg(temp1, temp1);
+    TRACE_OP(TRACE_POW_G1, element_pp_pow_zn(rj.u, temp1, pkg_params.g_pp));
+    TRACE_OP(TRACE_POW_G1, element_pp_pow_zn(temp2, k3, pkg_params.g1_pp));
     element_add(rj.u, rj.u, temp2);
 
     // v
-    element_pow_zn(rj.v, pkg_params.e_g_g, k3);
+    TRACE_STAGE("v");
+    TRACE_OP(TRACE_POW_GT, element_pp_pow_zn(rj.v, k3, pkg_params.e_g_g_pp));
 
     // w
-    element_invert(rj.w, pkg_params.e_g_h);
-    element_pow_zn(rj.w, rj.w, k3);
+    TRACE_STAGE("w");
+    TRACE_OP(TRACE_POW_GT, element_pp_pow_zn(rj.w, k3, pkg_params.e_g_h_inv_pp));
     element_mul(rj.w, rj.w, X);
+}
+
 
-    element_clear(temp1);
-    element_clear(temp2);
+// Receiver independent Rj terms of k3, shared.u holds g1^k3
+void ccaRjSharedGen(pkg_params &pkg_params, element_t X, element_t k3, ccaRj &shared)
+{
+    TRACE_FUNCTION("ccaRjSharedGen");
+    TRACE_OP(TRACE_POW_G1, element_pp_pow_zn(shared.u, k3, pkg_params.g1_pp));
+    TRACE_OP(TRACE_POW_GT, element_pp_pow_zn(shared.v, k3, pkg_params.e_g_g_pp));
+    TRACE_OP(TRACE_POW_GT, element_pp_pow_zn(shared.w, k3, pkg_params.e_g_h_inv_pp));
+    element_mul(shared.w, shared.w, X);
+}
 
+// Rj for user_Pub[begin..end) from the shared terms, only u depends on the receiver
+void ccaRjGenRange(pairing_t pairing, pkg_params &pkg_params, ccaRj &shared, element_t user_Pub[], element_t k3, int begin, int end, ccaRj rj[])
+{
+    TRACE_FUNCTION("ccaRjGenRange");
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.Zr();
+
+    for (int i = begin; i < end; i++)
+    {
+        // u
+        element_mul(temp1, k3, user_Pub[i]);
+        element_neg(temp1, temp1);
+        TRACE_OP(TRACE_POW_G1, element_pp_pow_zn(rj[i].u, temp1, pkg_params.g_pp));
+        element_add(rj[i].u, rj[i].u, shared.u);
+
+        element_set(rj[i].v, shared.v);
+        element_set(rj[i].w, shared.w);
+    }
 }
 
+// Batched Rj generation, g1^k3, v and w do not depend on the receiver
+void ccaRjGenBatch(pairing_t pairing, pkg_params &pkg_params, element_t user_Pub[], int receiver_number, element_t X, element_t k3, ccaRj rj[])
+{
+    ccaRj shared;
+    element_init_G1(shared.u, pairing);
+    element_init_GT(shared.v, pairing);
+    element_init_GT(shared.w, pairing);
+
+    ccaRjSharedGen(pkg_params, X, k3, shared);
+    ccaRjGenRange(pairing, pkg_params, shared, user_Pub, k3, 0, receiver_number, rj);
+
+    element_clear(shared.u);
+    element_clear(shared.v);
+    element_clear(shared.w);
+}
@@ -9,22 +9,69 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <iostream>
 #include <string.h>
 #include <stdint.h> 
 
 #include "sha.h"
 #include "pbc.h"
+#include "registry.h"
 #include "wots.h"
 #include "ccastruct.h"
 #include "ccaenc.h"
 #include "ccadec.h"
 #include "ccakeygen.h"
 #include "ccamap.h"
+#include "fanout.h"
+#include "codec.h"
+#include "hybrid.h"
+#include "precompute.h"
+#include "scratch.h"
 #include "sha.h"
 
 using namespace std;
 
+// Trades counted by the steady-state allocation check
+#define CCAMAIN_STEADY_RENUM 4
+
+// Heap blocks PBC and GMP hold, every hook forwards to libc
+static long ccamain_live_blocks = 0;
+
+static void *ccamain_count_malloc(size_t size)
+{
+    ccamain_live_blocks++;
+    return malloc(size);
+}
+
+static void *ccamain_count_realloc(void *ptr, size_t size)
+{
+    if (!ptr)
+    {
+        ccamain_live_blocks++;
+    }
+    return realloc(ptr, size);
+}
+
+static void ccamain_count_free(void *ptr)
+{
+    if (ptr)
+    {
+        ccamain_live_blocks--;
+    }
+    free(ptr);
+}
+
+static void *ccamain_count_mp_realloc(void *ptr, size_t, size_t new_size)
+{
+    return ccamain_count_realloc(ptr, new_size);
+}
+
+static void ccamain_count_mp_free(void *ptr, size_t)
+{
+    ccamain_count_free(ptr);
+}
+
 
 void print_hex(const char *label, const uint8_t *data, size_t len) {
     printf("%s: ", label);
@@ -42,26 +89,13 @@ void print_hex(const char *label, const uint8_t *data, size_t len) {
 
 
 // main function
-int ccamain()
+int ccamain(const char *param_file)
 {
-    pairing_t pairing; 
-
-    FILE *fp = fopen("../param/a.param", "r");
-    if (!fp)
+    pairing_ptr pairing = PairingAcquire(param_file);
+    if (!pairing)
     {
-        printf("[FAIL] Param file open fail.\n");
         return 1;
     }
-
-    char param[1024];
-    size_t count = fread(param, 1, sizeof(param), fp);
-    fclose(fp); 
-    if (!count)
-    {
-        printf("[FAIL] Parameters write fail.\n");
-    }
-    
-    pairing_init_set_str(pairing, param); 
     if (!pairing_is_symmetric(pairing))
     {
         printf("[Asymmetric] Pairing is an asymmetric pairing.\n");
@@ -74,14 +108,13 @@ int ccamain()
     uint8_t sk_seed[WOTS_N] = {1};
     uint8_t message[WOTS_N] = {0x12};
 
-    uint8_t pk1[WOTS_LEN][WOTS_N];
-    uint8_t pk2[WOTS_LEN][WOTS_N];
+    uint8_t pk_root[WOTS_N];
     uint8_t sig[WOTS_LEN][WOTS_N];
 
     // out put seed of sk, and msg
 
-    wots_keygen(pk1, sk_seed);
-    //print_hex("Public key (wots_keygen)", pk1, WOTS_LEN * WOTS_N);
+    wots_keygen_root(pk_root, sk_seed);
+    //print_hex("Public key root (wots_keygen_root)", pk_root, WOTS_N);
 
     element_t ts_priv, pkg_priv;
     element_init_Zr(ts_priv, pairing);
@@ -92,6 +125,8 @@ int ccamain()
     element_t vk, sk;
     element_init_Zr(vk, pairing);
     element_init_Zr(sk, pairing);
+    // a zero vk makes C6 the identity, and PBC leaks a block on every zero fixed-base power
+    element_random(vk);
 
     char Alice[] = "sender.alice@gmail.com";
     char Time[] = "2025-5-5 12:00:00";
@@ -111,36 +146,42 @@ int ccamain()
     ts_params ts_params; 
 
     element_init_G1(ts_params.g, pairing);
-    element_init_G1(ts_params.h, pairing);
+    element_init_G2(ts_params.g2, pairing);
+    element_init_G2(ts_params.h, pairing);
     element_init_G1(ts_params.g1, pairing);
     element_init_GT(ts_params.e_g_g, pairing);
     element_init_GT(ts_params.e_g_h, pairing);
     element_random(ts_params.g);
+    ParamsG2Generator(pairing, ts_params.g, ts_params.g2);
     element_random(ts_params.h);
     element_pow_zn(ts_params.g1, ts_params.g, ts_priv);
-    pairing_apply(ts_params.e_g_g, ts_params.g, ts_params.g, pairing);
+    pairing_apply(ts_params.e_g_g, ts_params.g, ts_params.g2, pairing);
     pairing_apply(ts_params.e_g_h, ts_params.g, ts_params.h, pairing);
+    TsParamsPrecompute(ts_params);
 
-    element_init_G1(pkg_params.g, pairing); 
-    element_init_G1(pkg_params.h, pairing);
+    element_init_G1(pkg_params.g, pairing);
+    element_init_G2(pkg_params.g2, pairing);
+    element_init_G2(pkg_params.h, pairing);
     element_init_G1(pkg_params.g1, pairing);
     element_init_GT(pkg_params.e_g_g, pairing);
     element_init_GT(pkg_params.e_g_h, pairing);
     element_random(pkg_params.g);
+    ParamsG2Generator(pairing, pkg_params.g, pkg_params.g2);
     element_random(pkg_params.h);
     element_pow_zn(pkg_params.g1, pkg_params.g, pkg_priv);
-    pairing_apply(pkg_params.e_g_g, pkg_params.g, pkg_params.g, pairing);
+    pairing_apply(pkg_params.e_g_g, pkg_params.g, pkg_params.g2, pairing);
     pairing_apply(pkg_params.e_g_h, pkg_params.g, pkg_params.h, pairing);
+    PkgParamsPrecompute(pkg_params);
 
     UserPrivateKey User_Alice_Priv, User_Bob_Priv; 
     TimeTrapDoor Time_St;
 
     element_init_Zr(User_Alice_Priv.r, pairing);
-    element_init_G1(User_Alice_Priv.K, pairing);
+    element_init_G2(User_Alice_Priv.K, pairing);
     element_init_Zr(Time_St.r, pairing);
-    element_init_G1(Time_St.K, pairing);
+    element_init_G2(Time_St.K, pairing);
     element_init_Zr(User_Bob_Priv.r, pairing);
-    element_init_G1(User_Bob_Priv.K, pairing);
+    element_init_G2(User_Bob_Priv.K, pairing);
     
     element_t PT;
     element_init_GT(PT, pairing);
@@ -156,7 +197,7 @@ int ccamain()
     element_init_G1(PCT.C3, pairing);
     element_init_GT(PCT.C4, pairing);
     element_init_GT(PCT.C5, pairing);
-    element_init_G1(PCT.C6, pairing);
+    element_init_G2(PCT.C6, pairing);
 
 
     ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, user_Alice_Pub, User_Alice_Priv);
@@ -170,57 +211,17 @@ int ccamain()
     
 
     // calculate SHA-256 hash of the ciphertext
-    element_t elements[6];
-    
-    element_init_G1(elements[0], pairing);   // 第1个元素：G1
-    element_init_GT(elements[1], pairing);   // 第2个元素：GT
-    element_init_G1(elements[2], pairing);   // 第3个元素：G1
-    element_init_GT(elements[3], pairing);   // 第4个元素：GT
-    element_init_GT(elements[4], pairing);   // 第5个元素：GT
-    element_init_G1(elements[5], pairing);   // 第6个元素：G1
-
-    element_set(elements[0] ,PCT.C1);
-    element_set(elements[1] ,PCT.C2);
-    element_set(elements[2] ,PCT.C3);
-    element_set(elements[3] ,PCT.C4);
-    element_set(elements[4] ,PCT.C5);
-    element_set(elements[5] ,PCT.C6);
-
-    size_t total_len = 0;
-    for (int i = 0; i < 6; i++) {
-        total_len += element_length_in_bytes(elements[i]);
-    }
-
-    // 
-    unsigned char *buffer = (unsigned char *)malloc(total_len);
-    if (!buffer) {
-        perror("[FAIL] Memory allocation failed.");
-        exit(1);
-    }
-
-    // 
-    size_t offset = 0;
-    for (int i = 0; i < 6; i++) {
-        int len = element_to_bytes(buffer + offset, elements[i]);
-        if (len != element_length_in_bytes(elements[i])) {
-            fprintf(stderr, "Serialization error: Element %d\n", i);
-            free(buffer);
-            exit(1);
-        }
-        offset += len;
-    }
-
-    SHA256(buffer, total_len, message); // hash to 256bit
+    ccaCiphertextDigest(PCT, message); // hash to 256bit
 
 
     wots_sign(sig, message, sk_seed);
     //print_hex("Signature (wots_sign)", sig, WOTS_LEN * WOTS_N);
 
     element_t rk, PX;
-    element_init_G1(rk, pairing);
+    element_init_G2(rk, pairing);
     element_init_GT(PX, pairing);
 
-    ccaRkGen(pairing, pkg_params, user_Alice_Pub, User_Alice_Priv, PCT, rk, PX);
+    ccaRkGen(pairing, User_Alice_Priv, PCT, rk, PX);
 
     element_t k3;
     element_init_Zr(k3, pairing);
@@ -231,7 +232,39 @@ int ccamain()
     element_init_GT(rj_bob.v, pairing);
     element_init_GT(rj_bob.w, pairing);
 
-    ccaRjGen(pairing, pkg_params, User_Alice_Priv, user_Bob_Pub, rk, PX, k3, rj_bob);
+    ccaRjGen(pairing, pkg_params, user_Bob_Pub, PX, k3, rj_bob);
+
+    // batched and fanned out Rj must match ccaRjGen receiver by receiver
+    element_t batch_Pub[2];
+    ccaRj rj_batch[2], rj_parallel[2];
+    element_init_Zr(batch_Pub[0], pairing);
+    element_init_Zr(batch_Pub[1], pairing);
+    element_set(batch_Pub[0], user_Alice_Pub);
+    element_set(batch_Pub[1], user_Bob_Pub);
+    for (int i = 0; i < 2; i++)
+    {
+        element_init_G1(rj_batch[i].u, pairing);
+        element_init_GT(rj_batch[i].v, pairing);
+        element_init_GT(rj_batch[i].w, pairing);
+        element_init_G1(rj_parallel[i].u, pairing);
+        element_init_GT(rj_parallel[i].v, pairing);
+        element_init_GT(rj_parallel[i].w, pairing);
+    }
+    ccaRjGenBatch(pairing, pkg_params, batch_Pub, 2, PX, k3, rj_batch);
+    ccaRjGenParallel(pairing, pkg_params, batch_Pub, 2, PX, k3, rj_parallel, 2);
+    bool rjbatchsuccess = !element_cmp(rj_batch[1].u, rj_bob.u) && !element_cmp(rj_batch[1].v, rj_bob.v) && !element_cmp(rj_batch[1].w, rj_bob.w);
+    for (int i = 0; i < 2; i++)
+    {
+        rjbatchsuccess = rjbatchsuccess && !element_cmp(rj_parallel[i].u, rj_batch[i].u) && !element_cmp(rj_parallel[i].v, rj_batch[i].v) && !element_cmp(rj_parallel[i].w, rj_batch[i].w);
+        element_clear(rj_batch[i].u);
+        element_clear(rj_batch[i].v);
+        element_clear(rj_batch[i].w);
+        element_clear(rj_parallel[i].u);
+        element_clear(rj_parallel[i].v);
+        element_clear(rj_parallel[i].w);
+        element_clear(batch_Pub[i]);
+    }
+    printf("Batched Rj generation %s\n", rjbatchsuccess ? "passed" : "failed");
 
     ccaReCiphertext RCT;
     element_init_G1(RCT.C1, pairing);
@@ -239,53 +272,238 @@ int ccamain()
     element_init_G1(RCT.C3, pairing);
     element_init_GT(RCT.C4, pairing);
     element_init_GT(RCT.C5, pairing);
-    element_init_G1(RCT.C6, pairing);
-    element_init_G1(RCT.RK2, pairing);
+    element_init_G2(RCT.C6, pairing);
+    element_init_G2(RCT.RK2, pairing);
     element_init_GT(RCT.C32, pairing);
 
 
-    wots_pk_from_sig(pk2, sig, message);
-    //print_hex("Recovered public key (wots_pk_from_sig)", pk2, WOTS_LEN * WOTS_N);
-
-    int receiversuccess = 1;
-    for (int i = 0; i < WOTS_LEN; i++) {
-        if (memcmp(pk1[i], pk2[i], WOTS_N) != 0) {
-            receiversuccess = 0;
-            break;
-        }
-    }
+    int receiversuccess = wots_verify(sig, message, pk_root);
     printf("WOTS+ verification %s\n", receiversuccess ? "passed" : "failed");
 
     ccaReEnc(pairing, PCT, rk, pkg_params, vk, RCT);
 
+    // proxy -> receiver, RCT travels in the codec wire format
+    unsigned char wire[4096];
+    size_t wire_len = ccaReCiphertextEncode(pairing, RCT, wire, sizeof(wire));
+    int codecsuccess = wire_len && ccaReCiphertextDecode(pairing, wire, wire_len, RCT);
+    if (!codecsuccess)
+    {
+        printf("[FAIL] ReCiphertext codec fail.\n");
+    }
+    else
+    {
+        printf("ReCiphertext wire size: %zu bytes\n", wire_len);
+    }
+
+    // the same re-encryption as a delta against the PCT the receiver already stores
+    ccaReDelta Delta;
+    element_init_G2(Delta.RK2, pairing);
+    element_init_GT(Delta.C32, pairing);
+    ccaReEncDelta(pairing, PCT, rk, pkg_params, vk, Delta);
+    wire_len = ccaReDeltaEncode(pairing, Delta, wire, sizeof(wire));
+    if (!wire_len || !ccaReDeltaDecode(pairing, wire, wire_len, Delta))
+    {
+        printf("[FAIL] ReDelta codec fail.\n");
+        codecsuccess = 0;
+    }
+    else
+    {
+        printf("ReDelta wire size: %zu bytes\n", wire_len);
+    }
+
+    // a GT value outside the order-r subgroup must not decode: flip the last byte of rj.v on the wire
+    ccaRj wire_rj;
+    element_init_G1(wire_rj.u, pairing);
+    element_init_GT(wire_rj.v, pairing);
+    element_init_GT(wire_rj.w, pairing);
+    wire_len = ccaRjEncode(pairing, rj_bob, wire, sizeof(wire));
+    int rejectsuccess = wire_len && ccaRjDecode(pairing, wire, wire_len, wire_rj) && !element_cmp(wire_rj.v, rj_bob.v);
+    if (rejectsuccess)
+    {
+        size_t v_at = CODEC_HEADER_LEN + 2 + (((size_t)wire[CODEC_HEADER_LEN] << 8) | wire[CODEC_HEADER_LEN + 1]);
+        size_t v_len = ((size_t)wire[v_at] << 8) | wire[v_at + 1];
+        wire[v_at + 2 + v_len - 1] ^= 0x01;
+        rejectsuccess = !ccaRjDecode(pairing, wire, wire_len, wire_rj);
+    }
+    printf("Codec rejection %s\n", rejectsuccess ? "passed" : "failed");
+    element_clear(wire_rj.u);
+    element_clear(wire_rj.v);
+    element_clear(wire_rj.w);
+
     element_t X;
     element_init_GT(X, pairing);
 
-    wots_pk_from_sig(pk2, sig, message);
-
-    ccaDec1(pairing, User_Bob_Priv, rj_bob, X);
-    element_printf("PX = %B\n", PX);
-    element_printf("X = %B\n", X);
+    // nothing past a failed decode is worth decrypting, fall through to the cleanup
+    if (codecsuccess)
+    {
+        ccaDec1(pairing, User_Bob_Priv, rj_bob, X);
+        element_printf("PX = %B\n", PX);
+        element_printf("X = %B\n", X);
+
+        ccaDec2(pairing, User_Bob_Priv, RCT, Time_St , rj_bob, X, PT_Bob);
+
+        element_t PT_Delta;
+        element_init_GT(PT_Delta, pairing);
+        int deltasuccess = ccaDec2Delta(pairing, User_Bob_Priv, PCT, Delta, Time_St, rj_bob, X, PT_Delta) && !element_cmp(PT_Delta, PT_Bob);
+        printf("ReDelta decryption %s\n", deltasuccess ? "passed" : "failed");
+
+        // a batch under one rk from ccaRkGenBatch, large enough for the preprocessed path,
+        // every RCT[i] and Delta[i] must decrypt with an Rj built from its own X[i]
+        ccaCiphertext batch_PCT[CCA_REENC_PP_MIN];
+        ccaReCiphertext batch_RCT[CCA_REENC_PP_MIN];
+        ccaReDelta batch_Delta[CCA_REENC_PP_MIN];
+        element_t batch_PT[CCA_REENC_PP_MIN], batch_vk[CCA_REENC_PP_MIN], batch_PX[CCA_REENC_PP_MIN];
+        element_t batch_rk, batch_X;
+        element_init_G2(batch_rk, pairing);
+        element_init_GT(batch_X, pairing);
+        ccaRj batch_rj;
+        element_init_G1(batch_rj.u, pairing);
+        element_init_GT(batch_rj.v, pairing);
+        element_init_GT(batch_rj.w, pairing);
+        for (int i = 0; i < CCA_REENC_PP_MIN; i++)
+        {
+            element_init_G1(batch_PCT[i].C1, pairing);
+            element_init_GT(batch_PCT[i].C2, pairing);
+            element_init_G1(batch_PCT[i].C3, pairing);
+            element_init_GT(batch_PCT[i].C4, pairing);
+            element_init_GT(batch_PCT[i].C5, pairing);
+            element_init_G2(batch_PCT[i].C6, pairing);
+            element_init_G1(batch_RCT[i].C1, pairing);
+            element_init_GT(batch_RCT[i].C2, pairing);
+            element_init_G1(batch_RCT[i].C3, pairing);
+            element_init_GT(batch_RCT[i].C4, pairing);
+            element_init_GT(batch_RCT[i].C5, pairing);
+            element_init_G2(batch_RCT[i].C6, pairing);
+            element_init_G2(batch_RCT[i].RK2, pairing);
+            element_init_GT(batch_RCT[i].C32, pairing);
+            element_init_G2(batch_Delta[i].RK2, pairing);
+            element_init_GT(batch_Delta[i].C32, pairing);
+            element_init_GT(batch_PT[i], pairing);
+            element_init_Zr(batch_vk[i], pairing);
+            element_init_GT(batch_PX[i], pairing);
+            element_random(batch_PT[i]);
+            element_random(batch_vk[i]);
+            ccaEnc(pairing, pkg_params, ts_params, user_Alice_Pub, User_Alice_Priv, Time_Pub, batch_vk[i], batch_PT[i], batch_PCT[i]);
+        }
+        ccaRkGenBatch(pairing, User_Alice_Priv, batch_PCT, CCA_REENC_PP_MIN, batch_rk, batch_PX);
+        ccaReEncBatch(pairing, batch_PCT, CCA_REENC_PP_MIN, batch_rk, pkg_params, batch_vk, batch_RCT);
+        ccaReEncDeltaBatch(pairing, batch_PCT, CCA_REENC_PP_MIN, batch_rk, pkg_params, batch_vk, batch_Delta);
+        int batchsuccess = 1;
+        for (int i = 0; i < CCA_REENC_PP_MIN; i++)
+        {
+            ccaRjGen(pairing, pkg_params, user_Bob_Pub, batch_PX[i], k3, batch_rj);
+            ccaDec1(pairing, User_Bob_Priv, batch_rj, batch_X);
+            ccaDec2(pairing, User_Bob_Priv, batch_RCT[i], Time_St, batch_rj, batch_X, PT_Delta);
+            batchsuccess = batchsuccess && !element_cmp(PT_Delta, batch_PT[i]);
+            batchsuccess = batchsuccess && ccaDec2Delta(pairing, User_Bob_Priv, batch_PCT[i], batch_Delta[i], Time_St, batch_rj, batch_X, PT_Delta) && !element_cmp(PT_Delta, batch_PT[i]);
+
+            element_clear(batch_PCT[i].C1);
+            element_clear(batch_PCT[i].C2);
+            element_clear(batch_PCT[i].C3);
+            element_clear(batch_PCT[i].C4);
+            element_clear(batch_PCT[i].C5);
+            element_clear(batch_PCT[i].C6);
+            element_clear(batch_RCT[i].C1);
+            element_clear(batch_RCT[i].C2);
+            element_clear(batch_RCT[i].C3);
+            element_clear(batch_RCT[i].C4);
+            element_clear(batch_RCT[i].C5);
+            element_clear(batch_RCT[i].C6);
+            element_clear(batch_RCT[i].RK2);
+            element_clear(batch_RCT[i].C32);
+            element_clear(batch_Delta[i].RK2);
+            element_clear(batch_Delta[i].C32);
+            element_clear(batch_PT[i]);
+            element_clear(batch_vk[i]);
+            element_clear(batch_PX[i]);
+        }
+        element_clear(batch_rk);
+        element_clear(batch_X);
+        element_clear(batch_rj.u);
+        element_clear(batch_rj.v);
+        element_clear(batch_rj.w);
+        printf("Batched re-encryption decryption %s\n", batchsuccess ? "passed" : "failed");
+        element_clear(PT_Delta);
+
+        // Hybrid payload, the document key is derived from PT and only the header above was re-encrypted
+        const char document[] = "Trade document: 100 units, settlement T+2.";
+        unsigned char key_Alice[HYBRID_KEY_LEN], key_Bob[HYBRID_KEY_LEN];
+        char recovered[sizeof(document)] = {0};
+        FILE *doc = tmpfile();
+        FILE *sealed = tmpfile();
+        FILE *opened = tmpfile();
+        int hybridsuccess = doc && sealed && opened;
+        if (!hybridsuccess)
+        {
+            perror("[FAIL] tmpfile fail.");
+        }
+        else
+        {
+            fwrite(document, 1, sizeof(document), doc);
+            rewind(doc);
+            HybridKey(PT, key_Alice);
+            hybridsuccess = HybridEncryptFile(key_Alice, doc, sealed);
+            rewind(sealed);
+            HybridKey(PT_Bob, key_Bob);
+            hybridsuccess = hybridsuccess && HybridDecryptFile(key_Bob, sealed, opened);
+            rewind(opened);
+            hybridsuccess = hybridsuccess && fread(recovered, 1, sizeof(recovered), opened) == sizeof(document)
+                            && !memcmp(recovered, document, sizeof(document));
+        }
+        printf("Hybrid payload decryption %s\n", hybridsuccess ? "passed" : "failed");
+        if (doc)
+        {
+            fclose(doc);
+        }
+        if (sealed)
+        {
+            fclose(sealed);
+        }
+        if (opened)
+        {
+            fclose(opened);
+        }
 
-    ccaDec2(pairing, User_Bob_Priv, RCT, Time_St , rj_bob, X, PT_Bob);
 
+        int sendersuccess = wots_verify(sig, message, pk_root);
+        printf("WOTS+ verification %s\n", sendersuccess ? "passed" : "failed");
 
-    wots_pk_from_sig(pk2, sig, message);
+        ccaSenderDec(pairing, pkg_params, ts_params, User_Alice_Priv, Time_St, PCT, PT_Alice);
+    }
+    element_clear(Delta.RK2);
+    element_clear(Delta.C32);
 
-    int sendersuccess = 1;
-    for (int i = 0; i < WOTS_LEN; i++) {
-        if (memcmp(pk1[i], pk2[i], WOTS_N) != 0) {
-            sendersuccess = 0;
-            break;
-        }
+    // Steady state: once the scratch arena and the outputs are warm, a whole trade must
+    // leave no heap block behind. PBC and GMP allocate inside pow and pairing and free it again.
+    auto trade = [&]()
+    {
+        ccaEnc(pairing, pkg_params, ts_params, user_Alice_Pub, User_Alice_Priv, Time_Pub, vk, PT, PCT);
+        ccaRkGen(pairing, User_Alice_Priv, PCT, rk, PX);
+        ccaRjGen(pairing, pkg_params, user_Bob_Pub, PX, k3, rj_bob);
+        ccaReEnc(pairing, PCT, rk, pkg_params, vk, RCT);
+        ccaDec1(pairing, User_Bob_Priv, rj_bob, X);
+        ccaDec2(pairing, User_Bob_Priv, RCT, Time_St, rj_bob, X, PT_Bob);
+        return !element_cmp(PT_Bob, PT);
+    };
+    int steadysuccess = trade();
+    pbc_set_memory_functions(ccamain_count_malloc, ccamain_count_realloc, ccamain_count_free);
+    mp_set_memory_functions(ccamain_count_malloc, ccamain_count_mp_realloc, ccamain_count_mp_free);
+    long live_blocks = ccamain_live_blocks;
+    for (int i = 0; i < CCAMAIN_STEADY_RENUM; i++)
+    {
+        steadysuccess = trade() && steadysuccess;
     }
-    printf("WOTS+ verification %s\n", sendersuccess ? "passed" : "failed");
-    
-    ccaSenderDec(pairing, pkg_params, ts_params, User_Alice_Priv, Time_St, PCT, PT_Alice);
+    live_blocks = ccamain_live_blocks - live_blocks;
+    mp_set_memory_functions(NULL, NULL, NULL);
+    pbc_set_memory_functions(malloc, realloc, free);
+    steadysuccess = steadysuccess && live_blocks == 0;
+    printf("Steady-state allocation check %s (%ld blocks left over %d trades)\n", steadysuccess ? "passed" : "failed", live_blocks, CCAMAIN_STEADY_RENUM);
 
     // clear memory
     element_clear(pkg_priv);
+    PkgParamsPrecomputeClear(pkg_params);
     element_clear(pkg_params.g);
+    element_clear(pkg_params.g2);
     element_clear(pkg_params.h);
     element_clear(pkg_params.g1);
     element_clear(pkg_params.e_g_g);
@@ -316,7 +534,9 @@ int ccamain()
     element_clear(RCT.C32);
 
     element_clear(ts_priv);
+    TsParamsPrecomputeClear(ts_params);
     element_clear(ts_params.g);
+    element_clear(ts_params.g2);
     element_clear(ts_params.h);
     element_clear(ts_params.g1);
     element_clear(ts_params.e_g_g);
@@ -335,7 +555,6 @@ int ccamain()
 
     element_clear(user_Bob_Pub);
 
-    pairing_clear(pairing);
 
-    return 1;
+    return codecsuccess && rejectsuccess && steadysuccess;
 }
\ No newline at end of file
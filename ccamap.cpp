@@ -7,18 +7,49 @@
  * @License: GPL v3.0
  * @Contact: ziyidong.cs@gmail.com
  */
+// SHA256_CTX is deprecated in OpenSSL 3 but, unlike EVP_MD_CTX, lives on the stack
+#define OPENSSL_SUPPRESS_DEPRECATED
 #include "pbc.h"
 #include "ccamap.h"
 #include "sha.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 
 // hash: {0,1}* -> Zr
 void ccaid_to_zr(pairing_t pairing, const char *id, element_t &upk) {
+    TRACE_FUNCTION("ccaid_to_zr");
     // 生成SHA-256哈希
     unsigned char digest[SHA256_DIGEST_LENGTH];
-    SHA256((unsigned char*)id, strlen(id), digest);
+    TRACE_OP(TRACE_HASH, SHA256((unsigned char*)id, strlen(id), digest));
 
     // 从哈希值加载元素
     element_from_hash(upk, digest, SHA256_DIGEST_LENGTH);
-}
\ No newline at end of file
+}
+
+
+// hash: ciphertext -> {0,1}^256, fields are streamed through one context
+void ccaCiphertextDigest(ccaCiphertext &PCT, unsigned char *digest)
+{
+    TRACE_FUNCTION("ccaCiphertextDigest");
+    TRACE_OP_SCOPE(TRACE_HASH);
+    element_ptr fields[6] = {PCT.C1, PCT.C2, PCT.C3, PCT.C4, PCT.C5, PCT.C6};
+    unsigned char buffer[CCA_DIGEST_ELEMENT_MAX];
+    SHA256_CTX ctx;
+
+    SHA256_Init(&ctx);
+    for (int i = 0; i < 6; i++)
+    {
+        int len = element_length_in_bytes(fields[i]);
+        if (len > CCA_DIGEST_ELEMENT_MAX)
+        {
+            fprintf(stderr, "[FAIL] Serialization error: Element %d is %d bytes, raise CCA_DIGEST_ELEMENT_MAX.\n", i, len);
+            exit(1);
+        }
+        element_to_bytes(buffer, fields[i]);
+        SHA256_Update(&ctx, buffer, len);
+    }
+    SHA256_Final(digest, &ctx);
+}
@@ -0,0 +1,353 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: ziyidong.cs@gmail.com
+ */
+#include <string.h>
+
+#include "pbc.h"
+#include "cpastruct.h"
+#include "ccastruct.h"
+#include "codec.h"
+
+
+// Curve points have a compressed form, GT and Zr elements do not
+static int codec_compressible(pairing_t pairing, element_ptr e)
+{
+    return e->field == pairing->G1 || e->field == pairing->G2;
+}
+
+// The point at infinity has no compressed form (PBC would write a point that decodes
+// to something else), it goes out as an empty field
+static size_t codec_field_length(pairing_t pairing, element_ptr e)
+{
+    if (codec_compressible(pairing, e))
+    {
+        return element_is0(e) ? 0 : element_length_in_bytes_compressed(e);
+    }
+    return element_length_in_bytes(e);
+}
+
+// x is the start of a compressed point from the wire, the curve has a point over it
+// only if x^3 + ax + b is a square. PBC takes the square root without asking and
+// does not return on a non-residue.
+static int codec_x_on_curve(element_ptr e, unsigned char *data, size_t len)
+{
+    element_ptr a = curve_field_a_coeff(e->field);
+    element_ptr b = curve_field_b_coeff(e->field);
+    element_t x, rhs;
+    element_init_same_as(x, a);
+    element_init_same_as(rhs, a);
+
+    // x is followed by a single 0/1 byte picking y
+    int valid = (size_t)element_length_in_bytes(x) + 1 == len && data[len - 1] <= 1;
+    if (valid)
+    {
+        element_from_bytes(x, data);
+        element_square(rhs, x);
+        element_add(rhs, rhs, a);
+        element_mul(rhs, rhs, x);
+        element_add(rhs, rhs, b);
+        valid = element_is_sqr(rhs);
+    }
+    element_clear(x);
+    element_clear(rhs);
+    return valid;
+}
+
+// A full-form point from the wire must satisfy y^2 = x^3 + ax + b
+static int codec_point_on_curve(element_ptr e)
+{
+    element_ptr x = element_x(e);
+    element_t lhs, rhs;
+    element_init_same_as(lhs, x);
+    element_init_same_as(rhs, x);
+    element_square(lhs, element_y(e));
+    element_square(rhs, x);
+    element_add(rhs, rhs, curve_field_a_coeff(e->field));
+    element_mul(rhs, rhs, x);
+    element_add(rhs, rhs, curve_field_b_coeff(e->field));
+    int valid = !element_cmp(lhs, rhs);
+    element_clear(lhs);
+    element_clear(rhs);
+    return valid;
+}
+
+// Points on the curve and GT values may still lie outside the order-r subgroup the scheme works in.
+// element_set0 gives the identity of GT as well.
+// The comparison goes through the field, so where PBC keeps a group as a quotient
+// (G2 of the MNT and BN curves) every coset representative passes as PBC intends.
+static int codec_in_subgroup(pairing_t pairing, element_ptr e)
+{
+    element_t t, zero;
+    element_init_same_as(t, e);
+    element_init_same_as(zero, e);
+    element_pow_mpz(t, e, pairing->r);
+    element_set0(zero);
+    int valid = !element_cmp(t, zero);
+    element_clear(t);
+    element_clear(zero);
+    return valid;
+}
+
+// A non-zero raw_len puts raw in front of the elements as an opaque field
+static size_t codec_length(pairing_t pairing, size_t raw_len, element_ptr fields[], int n)
+{
+    size_t total = CODEC_HEADER_LEN + (raw_len ? 2 + raw_len : 0);
+    for (int i = 0; i < n; i++)
+    {
+        total += 2 + codec_field_length(pairing, fields[i]);
+    }
+    return total;
+}
+
+static size_t codec_encode(pairing_t pairing, CodecType type, const unsigned char *raw, size_t raw_len, element_ptr fields[], int n, unsigned char *out, size_t out_len)
+{
+    size_t total = codec_length(pairing, raw_len, fields, n);
+    if (out_len < total)
+    {
+        return 0;
+    }
+
+    out[0] = CODEC_VERSION;
+    out[1] = (unsigned char)type;
+    out[2] = (unsigned char)(n + (raw_len ? 1 : 0));
+    size_t offset = CODEC_HEADER_LEN;
+    if (raw_len)
+    {
+        out[offset] = (unsigned char)(raw_len >> 8);
+        out[offset + 1] = (unsigned char)raw_len;
+        memcpy(out + offset + 2, raw, raw_len);
+        offset += 2 + raw_len;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        size_t len = codec_field_length(pairing, fields[i]);
+        out[offset] = (unsigned char)(len >> 8);
+        out[offset + 1] = (unsigned char)len;
+        offset += 2;
+        if (codec_compressible(pairing, fields[i]))
+        {
+            if (len)
+            {
+                element_to_bytes_compressed(out + offset, fields[i]);
+            }
+        }
+        else
+        {
+            element_to_bytes(out + offset, fields[i]);
+        }
+        offset += len;
+    }
+    return total;
+}
+
+// Every length is checked against the field before PBC reads from in, every
+// G1/G2 point against the curve and the order-r subgroup, and every GT value against the subgroup
+static int codec_decode(pairing_t pairing, CodecType type, const unsigned char *in, size_t in_len, unsigned char *raw, size_t raw_len, element_ptr fields[], int n)
+{
+    if (in_len < CODEC_HEADER_LEN || in[0] != CODEC_VERSION || in[1] != (unsigned char)type || in[2] != (unsigned char)(n + (raw_len ? 1 : 0)))
+    {
+        return 0;
+    }
+
+    size_t offset = CODEC_HEADER_LEN;
+    if (raw_len)
+    {
+        if (in_len - offset < 2 + raw_len || (((size_t)in[offset] << 8) | in[offset + 1]) != raw_len)
+        {
+            return 0;
+        }
+        memcpy(raw, in + offset + 2, raw_len);
+        offset += 2 + raw_len;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        if (in_len - offset < 2)
+        {
+            return 0;
+        }
+        size_t len = ((size_t)in[offset] << 8) | in[offset + 1];
+        offset += 2;
+        if (in_len - offset < len)
+        {
+            return 0;
+        }
+
+        // PBC takes non-const buffers but only reads them
+        unsigned char *data = (unsigned char *)in + offset;
+        if (codec_compressible(pairing, fields[i]) && len == 0)
+        {
+            element_set0(fields[i]);
+        }
+        else if (codec_compressible(pairing, fields[i]) && len == (size_t)element_length_in_bytes_compressed(fields[i]))
+        {
+            if (!codec_x_on_curve(fields[i], data, len))
+            {
+                return 0;
+            }
+            element_from_bytes_compressed(fields[i], data);
+            if (!codec_in_subgroup(pairing, fields[i]))
+            {
+                return 0;
+            }
+        }
+        else if (len == (size_t)element_length_in_bytes(fields[i]))
+        {
+            element_from_bytes(fields[i], data);
+            if (codec_compressible(pairing, fields[i]) && (!codec_point_on_curve(fields[i]) || !codec_in_subgroup(pairing, fields[i])))
+            {
+                return 0;
+            }
+            // GT is a subgroup of the extension field, a small-order value would leak the exponent it is raised to
+            if (fields[i]->field == pairing->GT && !codec_in_subgroup(pairing, fields[i]))
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            return 0;
+        }
+        offset += len;
+    }
+    return offset == in_len;
+}
+
+
+// Ciphertext
+size_t CiphertextEncodedLength(pairing_t pairing, Ciphertext &CT)
+{
+    element_ptr fields[5] = {CT.C1, CT.C2, CT.C3, CT.C4, CT.C5};
+    return codec_length(pairing, 0, fields, 5);
+}
+
+size_t CiphertextEncode(pairing_t pairing, Ciphertext &CT, unsigned char *out, size_t out_len)
+{
+    element_ptr fields[5] = {CT.C1, CT.C2, CT.C3, CT.C4, CT.C5};
+    return codec_encode(pairing, CODEC_CIPHERTEXT, NULL, 0, fields, 5, out, out_len);
+}
+
+int CiphertextDecode(pairing_t pairing, const unsigned char *in, size_t in_len, Ciphertext &CT)
+{
+    element_ptr fields[5] = {CT.C1, CT.C2, CT.C3, CT.C4, CT.C5};
+    return codec_decode(pairing, CODEC_CIPHERTEXT, in, in_len, NULL, 0, fields, 5);
+}
+
+// ReCiphertext
+size_t ReCiphertextEncodedLength(pairing_t pairing, ReCiphertext &RCT)
+{
+    element_ptr fields[5] = {RCT.C1, RCT.C2, RCT.C3, RCT.C4, RCT.C5};
+    return codec_length(pairing, 0, fields, 5);
+}
+
+size_t ReCiphertextEncode(pairing_t pairing, ReCiphertext &RCT, unsigned char *out, size_t out_len)
+{
+    element_ptr fields[5] = {RCT.C1, RCT.C2, RCT.C3, RCT.C4, RCT.C5};
+    return codec_encode(pairing, CODEC_RECIPHERTEXT, NULL, 0, fields, 5, out, out_len);
+}
+
+int ReCiphertextDecode(pairing_t pairing, const unsigned char *in, size_t in_len, ReCiphertext &RCT)
+{
+    element_ptr fields[5] = {RCT.C1, RCT.C2, RCT.C3, RCT.C4, RCT.C5};
+    return codec_decode(pairing, CODEC_RECIPHERTEXT, in, in_len, NULL, 0, fields, 5);
+}
+
+// Rj
+size_t RjEncodedLength(pairing_t pairing, Rj &rj)
+{
+    element_ptr fields[3] = {rj.u, rj.v, rj.w};
+    return codec_length(pairing, 0, fields, 3);
+}
+
+size_t RjEncode(pairing_t pairing, Rj &rj, unsigned char *out, size_t out_len)
+{
+    element_ptr fields[3] = {rj.u, rj.v, rj.w};
+    return codec_encode(pairing, CODEC_RJ, NULL, 0, fields, 3, out, out_len);
+}
+
+int RjDecode(pairing_t pairing, const unsigned char *in, size_t in_len, Rj &rj)
+{
+    element_ptr fields[3] = {rj.u, rj.v, rj.w};
+    return codec_decode(pairing, CODEC_RJ, in, in_len, NULL, 0, fields, 3);
+}
+
+// ccaCiphertext
+size_t ccaCiphertextEncodedLength(pairing_t pairing, ccaCiphertext &CT)
+{
+    element_ptr fields[6] = {CT.C1, CT.C2, CT.C3, CT.C4, CT.C5, CT.C6};
+    return codec_length(pairing, 0, fields, 6);
+}
+
+size_t ccaCiphertextEncode(pairing_t pairing, ccaCiphertext &CT, unsigned char *out, size_t out_len)
+{
+    element_ptr fields[6] = {CT.C1, CT.C2, CT.C3, CT.C4, CT.C5, CT.C6};
+    return codec_encode(pairing, CODEC_CCA_CIPHERTEXT, NULL, 0, fields, 6, out, out_len);
+}
+
+int ccaCiphertextDecode(pairing_t pairing, const unsigned char *in, size_t in_len, ccaCiphertext &CT)
+{
+    element_ptr fields[6] = {CT.C1, CT.C2, CT.C3, CT.C4, CT.C5, CT.C6};
+    return codec_decode(pairing, CODEC_CCA_CIPHERTEXT, in, in_len, NULL, 0, fields, 6);
+}
+
+// ccaReCiphertext
+size_t ccaReCiphertextEncodedLength(pairing_t pairing, ccaReCiphertext &RCT)
+{
+    element_ptr fields[8] = {RCT.C1, RCT.C2, RCT.C3, RCT.C4, RCT.C5, RCT.C6, RCT.RK2, RCT.C32};
+    return codec_length(pairing, 0, fields, 8);
+}
+
+size_t ccaReCiphertextEncode(pairing_t pairing, ccaReCiphertext &RCT, unsigned char *out, size_t out_len)
+{
+    element_ptr fields[8] = {RCT.C1, RCT.C2, RCT.C3, RCT.C4, RCT.C5, RCT.C6, RCT.RK2, RCT.C32};
+    return codec_encode(pairing, CODEC_CCA_RECIPHERTEXT, NULL, 0, fields, 8, out, out_len);
+}
+
+int ccaReCiphertextDecode(pairing_t pairing, const unsigned char *in, size_t in_len, ccaReCiphertext &RCT)
+{
+    element_ptr fields[8] = {RCT.C1, RCT.C2, RCT.C3, RCT.C4, RCT.C5, RCT.C6, RCT.RK2, RCT.C32};
+    return codec_decode(pairing, CODEC_CCA_RECIPHERTEXT, in, in_len, NULL, 0, fields, 8);
+}
+
+// ccaRj
+size_t ccaRjEncodedLength(pairing_t pairing, ccaRj &rj)
+{
+    element_ptr fields[3] = {rj.u, rj.v, rj.w};
+    return codec_length(pairing, 0, fields, 3);
+}
+
+size_t ccaRjEncode(pairing_t pairing, ccaRj &rj, unsigned char *out, size_t out_len)
+{
+    element_ptr fields[3] = {rj.u, rj.v, rj.w};
+    return codec_encode(pairing, CODEC_CCA_RJ, NULL, 0, fields, 3, out, out_len);
+}
+
+int ccaRjDecode(pairing_t pairing, const unsigned char *in, size_t in_len, ccaRj &rj)
+{
+    element_ptr fields[3] = {rj.u, rj.v, rj.w};
+    return codec_decode(pairing, CODEC_CCA_RJ, in, in_len, NULL, 0, fields, 3);
+}
+
+// ccaReDelta, ref travels as a leading opaque field
+size_t ccaReDeltaEncodedLength(pairing_t pairing, ccaReDelta &Delta)
+{
+    element_ptr fields[2] = {Delta.RK2, Delta.C32};
+    return codec_length(pairing, CCA_REF_LEN, fields, 2);
+}
+
+size_t ccaReDeltaEncode(pairing_t pairing, ccaReDelta &Delta, unsigned char *out, size_t out_len)
+{
+    element_ptr fields[2] = {Delta.RK2, Delta.C32};
+    return codec_encode(pairing, CODEC_CCA_REDELTA, Delta.ref, CCA_REF_LEN, fields, 2, out, out_len);
+}
+
+int ccaReDeltaDecode(pairing_t pairing, const unsigned char *in, size_t in_len, ccaReDelta &Delta)
+{
+    element_ptr fields[2] = {Delta.RK2, Delta.C32};
+    return codec_decode(pairing, CODEC_CCA_REDELTA, in, in_len, Delta.ref, CCA_REF_LEN, fields, 2);
+}
@@ -9,62 +9,47 @@
  */
 #include "pbc.h"
 #include "cpadec.h"
+#include "precompute.h"
+#include "scratch.h"
 
 
 // Sender decryption function
-void SenderDec(pairing_t pairing, pkg_params pkg_params, ts_params ts_params, UserPrivateKey User_Alice_Priv, TimeTrapDoor St, Ciphertext PCT, element_t &PT_Alice)
+void SenderDec(pairing_t pairing, pkg_params &pkg_params, ts_params &ts_params, UserPrivateKey &User_Alice_Priv, TimeTrapDoor &St, Ciphertext &PCT, element_t &PT_Alice)
 {
-    element_t temp1, temp2, temp3, temp4;
-    element_init_GT(temp1, pairing);
-    element_init_GT(temp2, pairing);
-    element_init_GT(temp3, pairing);
-    element_init_GT(temp4, pairing);
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
 
+    // e(C1, St.K) * e(C3, K)
+    PairingProd2(temp1, PCT.C1, St.K, PCT.C3, User_Alice_Priv.K, pairing);
 
-    pairing_apply(temp1, PCT.C1, St.K, pairing);
     element_pow_zn(temp2, PCT.C2, St.r);
-
-    pairing_apply(temp3, PCT.C3, User_Alice_Priv.K, pairing);
-
  
     element_mul(PT_Alice, temp1, temp2);
-    element_mul(PT_Alice, PT_Alice, temp3);
     element_mul(PT_Alice, PT_Alice, PCT.C4);
     element_mul(PT_Alice, PT_Alice, PCT.C5);
-
-    element_clear(temp1);
-    element_clear(temp2);
-    element_clear(temp3);
-    element_clear(temp4);
-
 }
 
 // Dec1 decryption function
-void Dec1(pairing_t pairing, UserPrivateKey User_Priv, Rj rj, element_t& X)
+void Dec1(pairing_t pairing, UserPrivateKey &User_Priv, Rj &rj, element_t& X)
 {
-    element_t temp1, temp2;
-    element_init_GT(temp1, pairing);
-    element_init_GT(temp2, pairing);
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
 
     
     pairing_apply(temp1, rj.u, User_Priv.K, pairing);
     element_pow_zn(temp2, rj.v, User_Priv.r);
     element_mul(X, temp1, temp2);
     element_mul(X, X, rj.w);
-
-
-    element_clear(temp1);
-    element_clear(temp2);
-
-
 }
 
 
-void Dec2(pairing_t pairing, UserPrivateKey User_Priv, ReCiphertext RCT, TimeTrapDoor St , Rj rj, element_t X, element_t& PT_Bob)
+void Dec2(pairing_t pairing, UserPrivateKey &User_Priv, ReCiphertext &RCT, TimeTrapDoor &St , Rj &rj, element_t X, element_t& PT_Bob)
 {
-    element_t temp1, temp2;
-    element_init_GT(temp1, pairing);
-    element_init_GT(temp2, pairing);
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
 
     pairing_apply(temp1, RCT.C1, St.K, pairing);
     element_pow_zn(temp2, RCT.C2, St.r);
@@ -73,9 +58,53 @@ void Dec2(pairing_t pairing, UserPrivateKey User_Priv, ReCiphertext RCT, TimeTra
     element_mul(PT_Bob, PT_Bob, RCT.C4);
     element_mul(PT_Bob, PT_Bob, RCT.C5);
     element_div(PT_Bob, PT_Bob, X);
+}
+
+
+// Sender decryption with prepared keys
+void SenderDec(pairing_t pairing, PreparedUserPrivateKey &User_Alice_Priv, PreparedTimeTrapDoor &St, Ciphertext &PCT, element_t &PT_Alice)
+{
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
+    element_ptr temp3 = frame.GT();
+
+    pairing_pp_apply(temp1, PCT.C1, St.K);
+    element_pow_zn(temp2, PCT.C2, St.r);
+
+    pairing_pp_apply(temp3, PCT.C3, User_Alice_Priv.K);
+
+    element_mul(PT_Alice, temp1, temp2);
+    element_mul(PT_Alice, PT_Alice, temp3);
+    element_mul(PT_Alice, PT_Alice, PCT.C4);
+    element_mul(PT_Alice, PT_Alice, PCT.C5);
+}
 
-    element_clear(temp1);
-    element_clear(temp2);
+// Dec1 with a prepared key
+void Dec1(pairing_t pairing, PreparedUserPrivateKey &User_Priv, Rj &rj, element_t& X)
+{
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
+
+    pairing_pp_apply(temp1, rj.u, User_Priv.K);
+    element_pow_zn(temp2, rj.v, User_Priv.r);
+    element_mul(X, temp1, temp2);
+    element_mul(X, X, rj.w);
+}
 
+// Dec2 with a prepared time trapdoor
+void Dec2(pairing_t pairing, PreparedUserPrivateKey &User_Priv, ReCiphertext &RCT, PreparedTimeTrapDoor &St , Rj &rj, element_t X, element_t& PT_Bob)
+{
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.GT();
+    element_ptr temp2 = frame.GT();
 
-}
\ No newline at end of file
+    pairing_pp_apply(temp1, RCT.C1, St.K);
+    element_pow_zn(temp2, RCT.C2, St.r);
+    element_mul(PT_Bob, temp1, temp2);
+    element_mul(PT_Bob, PT_Bob, RCT.C3);
+    element_mul(PT_Bob, PT_Bob, RCT.C4);
+    element_mul(PT_Bob, PT_Bob, RCT.C5);
+    element_div(PT_Bob, PT_Bob, X);
+}
@@ -9,59 +9,52 @@
  */
 #include "pbc.h"
 #include "cpaenc.h"
+#include "scratch.h"
 
 // Encryption function
-void Enc(pairing_t pairing, pkg_params pkg_params, ts_params ts_params, element_t user_Alice_Pub, UserPrivateKey User_Alice_Priv, element_t Time_Pub, element_t PT, Ciphertext &PCT)
+void Enc(pairing_t pairing, pkg_params &pkg_params, ts_params &ts_params, element_t user_Alice_Pub, UserPrivateKey &User_Alice_Priv, element_t Time_Pub, element_t PT, Ciphertext &PCT)
 {
+    ScratchFrame frame(pairing);
 
-    element_t k1, k2;
-    element_t temp1, temp2, temp3, temp4, temp5, temp6, temp7;
-
-    element_init_Zr(k1, pairing);
-    element_init_Zr(k2, pairing);
+    element_ptr k1 = frame.Zr();
+    element_ptr k2 = frame.Zr();
     element_random(k1);
     element_random(k2);
 
-    element_init_Zr(temp1, pairing);
-    element_init_G1(temp2, pairing);
-    element_init_GT(temp3, pairing);
-    element_init_Zr(temp4, pairing);
-    element_init_G1(temp5, pairing);
-    element_init_GT(temp6, pairing);
-    element_init_G1(temp7, pairing);
+    element_ptr temp1 = frame.Zr();
+    element_ptr temp2 = frame.G1();
+    element_ptr temp3 = frame.GT();
+    element_ptr temp4 = frame.Zr();
+    element_ptr temp5 = frame.G1();
+    element_ptr temp6 = frame.GT();
 
     // C1
     element_mul(temp1, k1, Time_Pub);
-    element_neg(PCT.C1, ts_params.g);
-    element_pow_zn(PCT.C1, PCT.C1, temp1);
-    element_pow_zn(temp2, ts_params.g1, k1);
+    element_neg(temp1, temp1);
+    element_pp_pow_zn(PCT.C1, temp1, ts_params.g_pp);
+    element_pp_pow_zn(temp2, k1, ts_params.g1_pp);
     element_add(PCT.C1, PCT.C1, temp2);
 
     // C2
-    element_pow_zn(PCT.C2, ts_params.e_g_g, k1);
+    element_pp_pow_zn(PCT.C2, k1, ts_params.e_g_g_pp);
 
     // C3
     element_mul(temp4, k2, user_Alice_Pub);
-    element_neg(PCT.C3, pkg_params.g);
-    element_pow_zn(PCT.C3, PCT.C3, temp4);
-    element_pow_zn(temp5, pkg_params.g1, k2);
+    element_neg(temp4, temp4);
+    element_pp_pow_zn(PCT.C3, temp4, pkg_params.g_pp);
+    element_pp_pow_zn(temp5, k2, pkg_params.g1_pp);
     element_add(PCT.C3, PCT.C3, temp5);
 
 
     // C4
-    element_pow_zn(PCT.C4, pkg_params.e_g_g, k2);   // {e(g,g)^k1}^{k2}
-    element_pow_zn(PCT.C4, PCT.C4, User_Alice_Priv.r);
-    
-    //element_mul(temp7, k2, User_Alice_Priv.r);
-    //element_pow_zn(PCT.C4, pkg_params.e_g_g, temp7);   // fail
+    element_mul(temp4, k2, User_Alice_Priv.r);
+    element_pp_pow_zn(PCT.C4, temp4, pkg_params.e_g_g_pp);   // e(g,g)^{k2 r}
 
 
     // C5
-    element_invert(temp3, ts_params.e_g_h);
-    element_pow_zn(temp3, temp3, k1);
+    element_pp_pow_zn(temp3, k1, ts_params.e_g_h_inv_pp);
 
-    element_invert(temp6, pkg_params.e_g_h);
-    element_pow_zn(temp6, temp6, k2);
+    element_pp_pow_zn(temp6, k2, pkg_params.e_g_h_inv_pp);
 
     //element_mul(PCT.C5, PT, temp3);
     //element_mul(PCT.C5, PT, temp6);
@@ -69,24 +62,13 @@ void Enc(pairing_t pairing, pkg_params pkg_params, ts_params ts_params, element_
 
     element_mul(PCT.C5, PT, temp3);
     element_mul(PCT.C5, PCT.C5, temp6);
-    
-
-    element_clear(k1);
-    element_clear(k2);
-    element_clear(temp1);
-    element_clear(temp2);
-    element_clear(temp3);
-    element_clear(temp4);
-    element_clear(temp5);
-    element_clear(temp6);
-    element_clear(temp7);
 
     // element_clear(result);
 }
 
 
 
-void ReEnc(pairing_t pairing, Ciphertext PCT, element_t rk, ReCiphertext &RCT)
+void ReEnc(pairing_t pairing, Ciphertext &PCT, element_t rk, ReCiphertext &RCT)
 {
 
  
@@ -104,6 +86,4 @@ void ReEnc(pairing_t pairing, Ciphertext PCT, element_t rk, ReCiphertext &RCT)
 
     //  RCT.C5 = PCT.C5;
     element_set(RCT.C5, PCT.C5);
-
-
 }
\ No newline at end of file
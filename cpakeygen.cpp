@@ -9,89 +9,119 @@
  */
 
 #include "cpakeygen.h"
+#include "scratch.h"
 
 
 // User private key generation
-void PrivatekeyGen(pairing_t pairing, element_t pkg_priv, pkg_params pkg_params, element_t user_Alice_Pub, UserPrivateKey &privatekey)
+void PrivatekeyGen(pairing_t pairing, element_t pkg_priv, pkg_params &pkg_params, element_t user_Alice_Pub, UserPrivateKey &privatekey)
 {
-    element_t diff, inv;
+    ScratchFrame frame(pairing);
     element_random(privatekey.r);
-    element_init_Zr(diff, pairing);
-    element_init_Zr(inv, pairing);
+    element_ptr diff = frame.Zr();
+    element_ptr inv = frame.Zr();
 
     element_sub(diff, pkg_priv, user_Alice_Pub);
     element_invert(inv, diff);
-    element_neg(privatekey.K, pkg_params.g);
-    element_pow_zn(privatekey.K, privatekey.K, privatekey.r);
+    element_pp_pow_zn(privatekey.K, privatekey.r, pkg_params.g_pp);
+    element_neg(privatekey.K, privatekey.K);
     element_add(privatekey.K, privatekey.K, pkg_params.h);
     element_pow_zn(privatekey.K, privatekey.K, inv);
-
-    element_clear(diff);
-    element_clear(inv);
 }
 
 
 // TimeTrapDoor generation
-void TimeTrapDoorGen(pairing_t pairing, element_t ts_priv, ts_params ts_params, element_t Time_Pub, TimeTrapDoor &Time_St)
+void TimeTrapDoorGen(pairing_t pairing, element_t ts_priv, ts_params &ts_params, element_t Time_Pub, TimeTrapDoor &Time_St)
 {
-    element_t diff, inv;            
+    ScratchFrame frame(pairing);
     element_random(Time_St.r); 
-    element_init_Zr(diff, pairing);
-    element_init_Zr(inv, pairing);
+    element_ptr diff = frame.Zr();
+    element_ptr inv = frame.Zr();
     
     element_sub(diff, ts_priv, Time_Pub); // diff �� a - b
     element_invert(inv, diff);
-    element_neg(Time_St.K, ts_params.g);
-    element_pow_zn(Time_St.K, Time_St.K, Time_St.r);
+    element_pp_pow_zn(Time_St.K, Time_St.r, ts_params.g_pp);
+    element_neg(Time_St.K, Time_St.K);
     element_add(Time_St.K, Time_St.K, ts_params.h);
     element_pow_zn(Time_St.K, Time_St.K, inv);
-
-
-    element_clear(diff);
-    element_clear(inv);
 }
 
 // RK, X generation function
-void RkGen(pairing_t pairing, pkg_params pkg_params, element_t user_Alice_Pub, UserPrivateKey User_Alice_Priv, Ciphertext PCT, element_t &rk, element_t &X)
+void RkGen(pairing_t pairing, pkg_params &pkg_params, element_t user_Alice_Pub, UserPrivateKey &User_Alice_Priv, Ciphertext &PCT, element_t &rk, element_t &X)
 {
-    element_t Q, temp;
-    element_init_G1(Q, pairing);
-    element_init_G1(temp, pairing);
+    ScratchFrame frame(pairing);
+    element_ptr Q = frame.G1();
+    element_ptr temp = frame.G1();
     
     element_random(Q);
 
     element_pow_zn(temp, Q, User_Alice_Priv.r);
     element_add(rk, temp, User_Alice_Priv.K);
     pairing_apply(X, PCT.C3, temp, pairing);
-
-    element_clear(Q);
-    element_clear(temp);
-
 }
 
 // Rj generation function;
-void RjGen(pairing_t pairing, pkg_params pkg_params, UserPrivateKey User_Alice_Priv, element_t user_Pub, element_t rk, element_t X, element_t k3, Rj &rj)
+void RjGen(pairing_t pairing, pkg_params &pkg_params, UserPrivateKey &User_Alice_Priv, element_t user_Pub, element_t rk, element_t X, element_t k3, Rj &rj)
 {
-    element_t temp1, temp2;
-    element_init_Zr(temp1, pairing);
-    element_init_G1(temp2, pairing);
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.Zr();
+    element_ptr temp2 = frame.G1();
 
     // u
     element_mul(temp1, k3, user_Pub);
-    element_neg(rj.u, pkg_params.g);
-    element_pow_zn(rj.u, rj.u, temp1);
-    element_pow_zn(temp2, pkg_params.g1, k3);
+    element_neg(temp1, temp1);
+    element_pp_pow_zn(rj.u, temp1, pkg_params.g_pp);
+    element_pp_pow_zn(temp2, k3, pkg_params.g1_pp);
     element_add(rj.u, rj.u, temp2);
 
     // v
-    element_pow_zn(rj.v, pkg_params.e_g_g, k3);
+    element_pp_pow_zn(rj.v, k3, pkg_params.e_g_g_pp);
 
     // w
-    element_invert(rj.w, pkg_params.e_g_h);
-    element_pow_zn(rj.w, rj.w, k3);
+    element_pp_pow_zn(rj.w, k3, pkg_params.e_g_h_inv_pp);
     element_mul(rj.w, rj.w, X);
+}
+
+
+// Receiver independent Rj terms of k3, shared.u holds g1^k3
+void RjSharedGen(pkg_params &pkg_params, element_t X, element_t k3, Rj &shared)
+{
+    element_pp_pow_zn(shared.u, k3, pkg_params.g1_pp);
+    element_pp_pow_zn(shared.v, k3, pkg_params.e_g_g_pp);
+    element_pp_pow_zn(shared.w, k3, pkg_params.e_g_h_inv_pp);
+    element_mul(shared.w, shared.w, X);
+}
+
+// Rj for user_Pub[begin..end) from the shared terms, only u depends on the receiver
+void RjGenRange(pairing_t pairing, pkg_params &pkg_params, Rj &shared, element_t user_Pub[], element_t k3, int begin, int end, Rj rj[])
+{
+    ScratchFrame frame(pairing);
+    element_ptr temp1 = frame.Zr();
+
+    for (int i = begin; i < end; i++)
+    {
+        // u
+        element_mul(temp1, k3, user_Pub[i]);
+        element_neg(temp1, temp1);
+        element_pp_pow_zn(rj[i].u, temp1, pkg_params.g_pp);
+        element_add(rj[i].u, rj[i].u, shared.u);
+
+        element_set(rj[i].v, shared.v);
+        element_set(rj[i].w, shared.w);
+    }
+}
+
+// Batched Rj generation, g1^k3, v and w do not depend on the receiver
+void RjGenBatch(pairing_t pairing, pkg_params &pkg_params, element_t user_Pub[], int receiver_number, element_t X, element_t k3, Rj rj[])
+{
+    Rj shared;
+    element_init_G1(shared.u, pairing);
+    element_init_GT(shared.v, pairing);
+    element_init_GT(shared.w, pairing);
 
-    element_clear(temp1);
-    element_clear(temp2);
+    RjSharedGen(pkg_params, X, k3, shared);
+    RjGenRange(pairing, pkg_params, shared, user_Pub, k3, 0, receiver_number, rj);
 
-}
\ No newline at end of file
+    element_clear(shared.u);
+    element_clear(shared.v);
+    element_clear(shared.w);
+}
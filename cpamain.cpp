@@ -13,35 +13,24 @@
 #include <string.h>
 
 #include "pbc.h"
+#include "registry.h"
 #include "cpastruct.h"
 #include "cpakeygen.h"
 #include "cpadec.h"
 #include "cpaenc.h"
 #include "cpamaptozr.h"
 #include "cpamain.h"
+#include "precompute.h"
+#include "scratch.h"
 
 
 int cpamain()
 {
-    pairing_t pairing; 
-
-    FILE *fp = fopen("../param/a.param", "r");
-    if (!fp)
+    pairing_ptr pairing = PairingAcquire("../param/a.param");
+    if (!pairing)
     {
-        printf("[FAIL] Param file open fail.\n");
         return 1;
     }
-
-    char param[10240];
-    size_t count = fread(param, 1, sizeof(param), fp);
-    fclose(fp); 
-    if (!count)
-    {
-        printf("[FAIL] Parameters write fail.\n");
-    }
-
-    
-    pairing_init_set_str(pairing, param); 
     if (!pairing_is_symmetric(pairing))
     {
         printf("[Asymmetric] Pairing is an asymmetric pairing.\n");
@@ -76,26 +65,32 @@ int cpamain()
     ts_params ts_params; 
 
     element_init_G1(ts_params.g, pairing);
+    element_init_G2(ts_params.g2, pairing);
     element_init_G1(ts_params.h, pairing);
     element_init_G1(ts_params.g1, pairing);
     element_init_GT(ts_params.e_g_g, pairing);
     element_init_GT(ts_params.e_g_h, pairing);
     element_random(ts_params.g);
+    ParamsG2Generator(pairing, ts_params.g, ts_params.g2);
     element_random(ts_params.h);
     element_pow_zn(ts_params.g1, ts_params.g, ts_priv);
-    pairing_apply(ts_params.e_g_g, ts_params.g, ts_params.g, pairing);
+    pairing_apply(ts_params.e_g_g, ts_params.g, ts_params.g2, pairing);
     pairing_apply(ts_params.e_g_h, ts_params.g, ts_params.h, pairing);
+    TsParamsPrecompute(ts_params);
 
-    element_init_G1(pkg_params.g, pairing); 
+    element_init_G1(pkg_params.g, pairing);
+    element_init_G2(pkg_params.g2, pairing);
     element_init_G1(pkg_params.h, pairing);
     element_init_G1(pkg_params.g1, pairing);
     element_init_GT(pkg_params.e_g_g, pairing);
     element_init_GT(pkg_params.e_g_h, pairing);
     element_random(pkg_params.g);
+    ParamsG2Generator(pairing, pkg_params.g, pkg_params.g2);
     element_random(pkg_params.h);
     element_pow_zn(pkg_params.g1, pkg_params.g, pkg_priv);
-    pairing_apply(pkg_params.e_g_g, pkg_params.g, pkg_params.g, pairing);
+    pairing_apply(pkg_params.e_g_g, pkg_params.g, pkg_params.g2, pairing);
     pairing_apply(pkg_params.e_g_h, pkg_params.g, pkg_params.h, pairing);
+    PkgParamsPrecompute(pkg_params);
 
     UserPrivateKey User_Alice_Priv, User_Bob_Priv; 
     TimeTrapDoor Time_St;
@@ -153,6 +148,30 @@ int cpamain()
     element_printf("rj_bob.v = %B\n", rj_bob.v);
     element_printf("rj_bob.w = %B\n", rj_bob.w);
 
+    // batched Rj must match RjGen receiver by receiver
+    element_t batch_Pub[2];
+    Rj rj_batch[2];
+    element_init_Zr(batch_Pub[0], pairing);
+    element_init_Zr(batch_Pub[1], pairing);
+    element_set(batch_Pub[0], user_Alice_Pub);
+    element_set(batch_Pub[1], user_Bob_Pub);
+    for (int i = 0; i < 2; i++)
+    {
+        element_init_G1(rj_batch[i].u, pairing);
+        element_init_GT(rj_batch[i].v, pairing);
+        element_init_GT(rj_batch[i].w, pairing);
+    }
+    RjGenBatch(pairing, pkg_params, batch_Pub, 2, PX, k3, rj_batch);
+    bool rjbatchsuccess = !element_cmp(rj_batch[1].u, rj_bob.u) && !element_cmp(rj_batch[1].v, rj_bob.v) && !element_cmp(rj_batch[1].w, rj_bob.w);
+    printf("Batched Rj generation %s\n", rjbatchsuccess ? "passed" : "failed");
+    for (int i = 0; i < 2; i++)
+    {
+        element_clear(rj_batch[i].u);
+        element_clear(rj_batch[i].v);
+        element_clear(rj_batch[i].w);
+        element_clear(batch_Pub[i]);
+    }
+
     ReCiphertext RCT;
     element_init_G1(RCT.C1, pairing);
     element_init_GT(RCT.C2, pairing);
@@ -187,7 +206,9 @@ int cpamain()
 
 
     element_clear(pkg_priv);
+    PkgParamsPrecomputeClear(pkg_params);
     element_clear(pkg_params.g);
+    element_clear(pkg_params.g2);
     element_clear(pkg_params.h);
     element_clear(pkg_params.g1);
     element_clear(pkg_params.e_g_g);
@@ -218,7 +239,9 @@ int cpamain()
     element_clear(RCT.C5);
 
     element_clear(ts_priv);
+    TsParamsPrecomputeClear(ts_params);
     element_clear(ts_params.g);
+    element_clear(ts_params.g2);
     element_clear(ts_params.h);
     element_clear(ts_params.g1);
     element_clear(ts_params.e_g_g);
@@ -234,7 +257,6 @@ int cpamain()
 
     element_clear(user_Bob_Pub);
 
-    pairing_clear(pairing);
 
     return 1;
 }
\ No newline at end of file
@@ -0,0 +1,170 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: ziyidong.cs@gmail.com
+ */
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "pbc.h"
+#include "ccastruct.h"
+#include "cpastruct.h"
+#include "ccakeygen.h"
+#include "fanout.h"
+#include "scratch.h"
+
+// Chunks per worker when the caller does not pick a chunk size
+#define FANOUT_CHUNKS_PER_WORKER 8
+
+// Per-worker chunk deque, the owner pops the front and thieves take the back
+typedef struct FanoutQueue
+{
+    std::mutex lock;
+    std::deque<int> chunks;
+} FanoutQueue;
+
+
+int FanoutThreads(int threads)
+{
+    if (threads > 0)
+    {
+        return threads;
+    }
+    int cores = (int)std::thread::hardware_concurrency();
+    return cores > 0 ? cores : 1;
+}
+
+static bool fanout_pop(FanoutQueue &queue, int &chunk)
+{
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.chunks.empty())
+    {
+        return false;
+    }
+    chunk = queue.chunks.front();
+    queue.chunks.pop_front();
+    return true;
+}
+
+static bool fanout_steal(std::vector<FanoutQueue> &queues, int worker, int &chunk)
+{
+    int workers = (int)queues.size();
+    for (int i = 1; i < workers; i++)
+    {
+        FanoutQueue &victim = queues[(worker + i) % workers];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.chunks.empty())
+        {
+            chunk = victim.chunks.back();
+            victim.chunks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void FanoutParallelFor(int n, int chunk, int threads, const std::function<void(int worker, int begin, int end)> &fn)
+{
+    if (n <= 0)
+    {
+        return;
+    }
+    int workers = FanoutThreads(threads);
+    if (chunk <= 0)
+    {
+        chunk = n / (workers * FANOUT_CHUNKS_PER_WORKER);
+        chunk = chunk > 0 ? chunk : 1;
+    }
+    int chunk_number = (n + chunk - 1) / chunk;
+    if (workers > chunk_number)
+    {
+        workers = chunk_number;
+    }
+    if (workers == 1)
+    {
+        fn(0, 0, n);
+        return;
+    }
+
+    // Contiguous runs of chunks per worker, stealing only kicks in on imbalance
+    std::vector<FanoutQueue> queues(workers);
+    for (int c = 0; c < chunk_number; c++)
+    {
+        queues[(long)c * workers / chunk_number].chunks.push_back(c);
+    }
+
+    // No chunk is ever re-queued, so a worker that finds every deque empty is done
+    auto run = [&](int worker) {
+        int c;
+        while (fanout_pop(queues[worker], c) || fanout_steal(queues, worker, c))
+        {
+            int begin = c * chunk;
+            int end = begin + chunk < n ? begin + chunk : n;
+            fn(worker, begin, end);
+        }
+        // Pool threads exit here, hand their scratch arenas back before that
+        if (worker != 0)
+        {
+            ScratchArenaRelease();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int worker = 1; worker < workers; worker++)
+    {
+        pool.emplace_back(run, worker);
+    }
+    run(0);
+    for (auto &t : pool)
+    {
+        t.join();
+    }
+}
+
+
+// Parallel user private key generation, ccaPrivatekeyGen per receiver
+void ccaPrivatekeyGenParallel(pairing_t pairing, element_t pkg_priv, pkg_params &pkg_params, element_t user_Pub[], int receiver_number, UserPrivateKey privatekey[], int threads)
+{
+    FanoutParallelFor(receiver_number, 0, threads, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i++)
+        {
+            ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, user_Pub[i], privatekey[i]);
+        }
+    });
+}
+
+// Parallel Rj generation, the receiver independent terms are computed once as in ccaRjGenBatch
+void ccaRjGenParallel(pairing_t pairing, pkg_params &pkg_params, element_t user_Pub[], int receiver_number, element_t X, element_t k3, ccaRj rj[], int threads)
+{
+    ccaRj shared;
+    element_init_G1(shared.u, pairing);
+    element_init_GT(shared.v, pairing);
+    element_init_GT(shared.w, pairing);
+
+    ccaRjSharedGen(pkg_params, X, k3, shared);
+    FanoutParallelFor(receiver_number, 0, threads, [&](int, int begin, int end) {
+        ccaRjGenRange(pairing, pkg_params, shared, user_Pub, k3, begin, end, rj);
+    });
+
+    element_clear(shared.u);
+    element_clear(shared.v);
+    element_clear(shared.w);
+}
+
+
+// Chunks are whole lane groups so every multi-lane call stays full
+void wots_keygen_parallel(WotsKeyBatch &batch, const uint8_t *sk_seed, int threads)
+{
+    int workers = FanoutThreads(threads);
+    int chunk = batch.count / (workers * FANOUT_CHUNKS_PER_WORKER);
+    chunk = chunk < WOTS_BATCH_LANES ? WOTS_BATCH_LANES : (chunk + WOTS_BATCH_LANES - 1) / WOTS_BATCH_LANES * WOTS_BATCH_LANES;
+    FanoutParallelFor(batch.count, chunk, workers, [&](int, int begin, int end) {
+        wots_keygen_batch(batch, sk_seed, begin, end);
+    });
+}
@@ -8,8 +8,404 @@
  * @Contact: ziyidong.cs@gmail.com
  */
 #include "hash.h"
+#include <stdlib.h>
+#include <string.h>
 #include <openssl/sha.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HASH_X86 1
+#endif
+
 void hash_sha256(const uint8_t *input, size_t inlen, uint8_t *out) {
     SHA256(input, inlen, out);
 }
+
+
+// SHA-256 of a 32-byte message is a single block: the message, 0x80, zeros and the bit length 256
+static const uint32_t sha256_iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define SHA256_PAD_WORD 0x80000000u
+#define SHA256_LEN_WORD 256u
+#define SHA256_INDEXED_LEN_WORD 288u
+
+// Words 8..15 of the block, after 32 bytes of message and after 32 bytes plus a 4-byte index
+static const uint32_t sha256_32_tail[8] = {SHA256_PAD_WORD, 0, 0, 0, 0, 0, 0, SHA256_LEN_WORD};
+
+static inline uint32_t load_be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void store_be32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static inline uint32_t ror32(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+
+// Portable one-lane kernel, the fallback on every other CPU. Works on the digest
+// as eight words, so a chain step feeds the output straight back in.
+static void sha256_32_scalar_words(uint32_t v[8], const uint32_t tail[8]) {
+    uint32_t w[64];
+    for (int i = 0; i < 8; i++) {
+        w[i] = v[i];
+        w[8 + i] = tail[i];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ror32(w[i - 15], 7) ^ ror32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ror32(w[i - 2], 17) ^ ror32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = sha256_iv[0], b = sha256_iv[1], c = sha256_iv[2], d = sha256_iv[3];
+    uint32_t e = sha256_iv[4], f = sha256_iv[5], g = sha256_iv[6], h = sha256_iv[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        uint32_t t2 = (ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    v[0] = a + sha256_iv[0];
+    v[1] = b + sha256_iv[1];
+    v[2] = c + sha256_iv[2];
+    v[3] = d + sha256_iv[3];
+    v[4] = e + sha256_iv[4];
+    v[5] = f + sha256_iv[5];
+    v[6] = g + sha256_iv[6];
+    v[7] = h + sha256_iv[7];
+}
+
+static void sha256_32_scalar_iter(uint8_t *out, const uint8_t *in, int steps) {
+    uint32_t v[8];
+    for (int i = 0; i < 8; i++) {
+        v[i] = load_be32(in + 4 * i);
+    }
+    for (int r = 0; r < steps; r++) {
+        sha256_32_scalar_words(v, sha256_32_tail);
+    }
+    for (int i = 0; i < 8; i++) {
+        store_be32(out + 4 * i, v[i]);
+    }
+}
+
+
+static void sha256_32_scalar_indexed(uint8_t *out, const uint8_t *in, uint32_t index) {
+    const uint32_t tail[8] = {index, SHA256_PAD_WORD, 0, 0, 0, 0, 0, SHA256_INDEXED_LEN_WORD};
+    uint32_t v[8];
+    for (int i = 0; i < 8; i++) {
+        v[i] = load_be32(in + 4 * i);
+    }
+    sha256_32_scalar_words(v, tail);
+    for (int i = 0; i < 8; i++) {
+        store_be32(out + 4 * i, v[i]);
+    }
+}
+
+
+#ifdef HASH_X86
+
+// SHA extensions, one lane, four rounds per sha256rnds2 pair. w0/w1 hold the
+// message as words on entry and the digest as words on return, w2/w3 the rest
+// of the block.
+__attribute__((target("sha,sse4.1")))
+static inline void sha256_32_shani_words(__m128i &w0, __m128i &w1, __m128i w2, __m128i w3) {
+    __m128i msg[4];
+    __m128i tmp, state0, state1;
+
+    // IV in the ABEF / CDGH layout expected by sha256rnds2
+    const __m128i abef = _mm_set_epi32((int)sha256_iv[0], (int)sha256_iv[1], (int)sha256_iv[4], (int)sha256_iv[5]);
+    const __m128i cdgh = _mm_set_epi32((int)sha256_iv[2], (int)sha256_iv[3], (int)sha256_iv[6], (int)sha256_iv[7]);
+    state0 = abef;
+    state1 = cdgh;
+
+    msg[0] = w0;
+    msg[1] = w1;
+    msg[2] = w2;
+    msg[3] = w3;
+
+    for (int i = 0; i < 16; i++) {
+        __m128i m;
+        if (i < 4) {
+            m = msg[i];
+        } else {
+            m = _mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]);
+            m = _mm_add_epi32(m, _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4));
+            m = _mm_sha256msg2_epu32(m, msg[(i + 3) & 3]);
+            msg[i & 3] = m;
+        }
+        m = _mm_add_epi32(m, _mm_loadu_si128((const __m128i *)&sha256_k[4 * i]));
+        state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+        m = _mm_shuffle_epi32(m, 0x0E);
+        state0 = _mm_sha256rnds2_epu32(state0, state1, m);
+    }
+
+    state0 = _mm_add_epi32(state0, abef);
+    state1 = _mm_add_epi32(state1, cdgh);
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    w0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    w1 = _mm_alignr_epi8(state1, tmp, 8);
+}
+
+// input is loaded in full before out is written, so they may alias
+__attribute__((target("sha,sse4.1")))
+static void sha256_32_shani_iter(uint8_t *out, const uint8_t *in, int steps) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)in), bswap);
+    __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + 16)), bswap);
+    const __m128i w2 = _mm_set_epi32(0, 0, 0, (int)SHA256_PAD_WORD);
+    const __m128i w3 = _mm_set_epi32((int)SHA256_LEN_WORD, 0, 0, 0);
+    for (int r = 0; r < steps; r++) {
+        sha256_32_shani_words(w0, w1, w2, w3);
+    }
+    _mm_storeu_si128((__m128i *)out, _mm_shuffle_epi8(w0, bswap));
+    _mm_storeu_si128((__m128i *)(out + 16), _mm_shuffle_epi8(w1, bswap));
+}
+
+
+__attribute__((target("sha,sse4.1")))
+static void sha256_32_shani_indexed(uint8_t *out, const uint8_t *in, uint32_t index) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)in), bswap);
+    __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + 16)), bswap);
+    sha256_32_shani_words(w0, w1, _mm_set_epi32(0, 0, (int)SHA256_PAD_WORD, (int)index),
+                          _mm_set_epi32((int)SHA256_INDEXED_LEN_WORD, 0, 0, 0));
+    _mm_storeu_si128((__m128i *)out, _mm_shuffle_epi8(w0, bswap));
+    _mm_storeu_si128((__m128i *)(out + 16), _mm_shuffle_epi8(w1, bswap));
+}
+
+
+#define AVX2_ROR(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+
+// AVX2, eight lanes in lockstep, one 32-bit lane per message
+__attribute__((target("avx2")))
+static void sha256_32_x8_avx2(uint8_t *const out[8], const uint8_t *const in[8]) {
+    __m256i w[16];
+    for (int j = 0; j < 8; j++) {
+        w[j] = _mm256_setr_epi32((int)load_be32(in[0] + 4 * j), (int)load_be32(in[1] + 4 * j),
+                                 (int)load_be32(in[2] + 4 * j), (int)load_be32(in[3] + 4 * j),
+                                 (int)load_be32(in[4] + 4 * j), (int)load_be32(in[5] + 4 * j),
+                                 (int)load_be32(in[6] + 4 * j), (int)load_be32(in[7] + 4 * j));
+    }
+    w[8] = _mm256_set1_epi32((int)SHA256_PAD_WORD);
+    for (int j = 9; j < 15; j++) {
+        w[j] = _mm256_setzero_si256();
+    }
+    w[15] = _mm256_set1_epi32((int)SHA256_LEN_WORD);
+
+    __m256i a = _mm256_set1_epi32((int)sha256_iv[0]), b = _mm256_set1_epi32((int)sha256_iv[1]);
+    __m256i c = _mm256_set1_epi32((int)sha256_iv[2]), d = _mm256_set1_epi32((int)sha256_iv[3]);
+    __m256i e = _mm256_set1_epi32((int)sha256_iv[4]), f = _mm256_set1_epi32((int)sha256_iv[5]);
+    __m256i g = _mm256_set1_epi32((int)sha256_iv[6]), h = _mm256_set1_epi32((int)sha256_iv[7]);
+    for (int i = 0; i < 64; i++) {
+        if (i >= 16) {
+            __m256i w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+            __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROR(w15, 7), AVX2_ROR(w15, 18)), _mm256_srli_epi32(w15, 3));
+            __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROR(w2, 17), AVX2_ROR(w2, 19)), _mm256_srli_epi32(w2, 10));
+            w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0), _mm256_add_epi32(w[(i - 7) & 15], s1));
+        }
+        __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROR(e, 6), AVX2_ROR(e, 11)), AVX2_ROR(e, 25));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, S1), _mm256_add_epi32(ch, _mm256_add_epi32(_mm256_set1_epi32((int)sha256_k[i]), w[i & 15])));
+        __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROR(a, 2), AVX2_ROR(a, 13)), AVX2_ROR(a, 22));
+        __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        __m256i t2 = _mm256_add_epi32(S0, maj);
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+
+    uint32_t state[8][8];
+    __m256i v[8] = {a, b, c, d, e, f, g, h};
+    for (int j = 0; j < 8; j++) {
+        v[j] = _mm256_add_epi32(v[j], _mm256_set1_epi32((int)sha256_iv[j]));
+        _mm256_storeu_si256((__m256i *)state[j], v[j]);
+    }
+    for (int lane = 0; lane < 8; lane++) {
+        for (int j = 0; j < 8; j++) {
+            store_be32(out[lane] + 4 * j, state[j][lane]);
+        }
+    }
+}
+
+#endif
+
+
+static int sha256_kernel_supported(Sha256Kernel kernel) {
+    switch (kernel) {
+    case SHA256_KERNEL_SCALAR:
+        return 1;
+#ifdef HASH_X86
+    case SHA256_KERNEL_SHANI:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1");
+    case SHA256_KERNEL_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return 0;
+    }
+}
+
+static Sha256Kernel sha256_pick_kernel() {
+    // ECR_SHA256_KERNEL=scalar|shani|avx2 pins a kernel the CPU can run
+    const char *name = getenv("ECR_SHA256_KERNEL");
+    if (name) {
+        static const char *const names[] = {"scalar", "shani", "avx2"};
+        for (int k = 0; k < 3; k++) {
+            if (!strcmp(name, names[k]) && sha256_kernel_supported((Sha256Kernel)k)) {
+                return (Sha256Kernel)k;
+            }
+        }
+    }
+    if (sha256_kernel_supported(SHA256_KERNEL_SHANI)) {
+        return SHA256_KERNEL_SHANI;
+    }
+    if (sha256_kernel_supported(SHA256_KERNEL_AVX2)) {
+        return SHA256_KERNEL_AVX2;
+    }
+    return SHA256_KERNEL_SCALAR;
+}
+
+// picked once, the CPU does not change under us, only hash_sha256_set_kernel moves it
+static Sha256Kernel &sha256_kernel_slot() {
+    static Sha256Kernel kernel = sha256_pick_kernel();
+    return kernel;
+}
+
+static Sha256Kernel sha256_kernel() {
+    return sha256_kernel_slot();
+}
+
+Sha256Kernel hash_sha256_kernel() {
+    return sha256_kernel_slot();
+}
+
+int hash_sha256_set_kernel(Sha256Kernel kernel) {
+    if (!sha256_kernel_supported(kernel)) {
+        return 0;
+    }
+    sha256_kernel_slot() = kernel;
+    return 1;
+}
+
+void hash_sha256_32(uint8_t *out, const uint8_t *in) {
+#ifdef HASH_X86
+    if (sha256_kernel() == SHA256_KERNEL_SHANI) {
+        sha256_32_shani_iter(out, in, 1);
+        return;
+    }
+#endif
+    sha256_32_scalar_iter(out, in, 1);
+}
+
+void hash_sha256_32_indexed(uint8_t *out, const uint8_t *in, uint32_t index) {
+#ifdef HASH_X86
+    if (sha256_kernel() == SHA256_KERNEL_SHANI) {
+        sha256_32_shani_indexed(out, in, index);
+        return;
+    }
+#endif
+    sha256_32_scalar_indexed(out, in, index);
+}
+
+void hash_sha256_32_multi(uint8_t *const out[], const uint8_t *const in[], int n) {
+    Sha256Kernel kernel = sha256_kernel();
+    int i = 0;
+#ifdef HASH_X86
+    if (kernel == SHA256_KERNEL_AVX2) {
+        for (; i + 8 <= n; i += 8) {
+            sha256_32_x8_avx2(out + i, in + i);
+        }
+        // a short tail still costs less as one padded 8-lane call
+        if (i < n) {
+            uint8_t spare[32] = {0};
+            uint8_t *tail_out[8];
+            const uint8_t *tail_in[8];
+            for (int l = 0; l < 8; l++) {
+                tail_out[l] = i + l < n ? out[i + l] : spare;
+                tail_in[l] = i + l < n ? in[i + l] : spare;
+            }
+            sha256_32_x8_avx2(tail_out, tail_in);
+            i = n;
+        }
+    } else if (kernel == SHA256_KERNEL_SHANI) {
+        for (; i < n; i++) {
+            sha256_32_shani_iter(out[i], in[i], 1);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        sha256_32_scalar_iter(out[i], in[i], 1);
+    }
+}
+
+void hash_sha256_32_chains(uint8_t *const buf[], const int steps[], int n) {
+#ifdef HASH_X86
+    // eight lanes only pay off in lockstep, one step of every running chain per
+    // call, over batches of up to 64 chains so the lane list stays on the stack
+    if (sha256_kernel() == SHA256_KERNEL_AVX2) {
+        for (int base = 0; base < n; base += 64) {
+            int batch = n - base < 64 ? n - base : 64;
+            int rounds = 0;
+            for (int i = 0; i < batch; i++) {
+                if (steps[base + i] > rounds) {
+                    rounds = steps[base + i];
+                }
+            }
+            uint8_t *lane[64];
+            for (int r = 0; r < rounds; r++) {
+                int m = 0;
+                for (int i = 0; i < batch; i++) {
+                    if (steps[base + i] > r) {
+                        lane[m++] = buf[base + i];
+                    }
+                }
+                hash_sha256_32_multi(lane, lane, m);
+            }
+        }
+        return;
+    }
+    // single-lane kernels keep a chain in registers until it ends
+    if (sha256_kernel() == SHA256_KERNEL_SHANI) {
+        for (int i = 0; i < n; i++) {
+            sha256_32_shani_iter(buf[i], buf[i], steps[i]);
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < n; i++) {
+        sha256_32_scalar_iter(buf[i], buf[i], steps[i]);
+    }
+}
@@ -0,0 +1,256 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: ziyidong.cs@gmail.com
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include "pbc.h"
+#include "hybrid.h"
+
+#define HYBRID_DOMAIN "ECR-TDPDS hybrid key v1"
+#define HYBRID_GT_MAX 1024
+
+
+static void hybrid_fail(const char *what)
+{
+    fprintf(stderr, "[FAIL] %s.\n", what);
+    exit(1);
+}
+
+static void hybrid_put32(unsigned char *out, uint32_t v)
+{
+    out[0] = (unsigned char)(v >> 24);
+    out[1] = (unsigned char)(v >> 16);
+    out[2] = (unsigned char)(v >> 8);
+    out[3] = (unsigned char)v;
+}
+
+static uint32_t hybrid_get32(const unsigned char *in)
+{
+    return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+}
+
+// nonce = prefix || counter, big-endian
+static void hybrid_nonce(HybridStream &stream, unsigned char *nonce)
+{
+    memcpy(nonce, stream.prefix, HYBRID_NONCE_PREFIX_LEN);
+    hybrid_put32(nonce + HYBRID_NONCE_PREFIX_LEN, stream.counter);
+}
+
+static void hybrid_init(HybridStream &stream, const unsigned char *key, int enc)
+{
+    stream.ctx = EVP_CIPHER_CTX_new();
+    if (!stream.ctx)
+    {
+        hybrid_fail("EVP_CIPHER_CTX_new failed");
+    }
+    if (EVP_CipherInit_ex(stream.ctx, EVP_aes_256_gcm(), NULL, key, NULL, enc) != 1)
+    {
+        hybrid_fail("AES-256-GCM key setup failed");
+    }
+    stream.counter = 0;
+    stream.done = 0;
+}
+
+
+void HybridKey(element_t PT, unsigned char *key)
+{
+    unsigned char buffer[sizeof(HYBRID_DOMAIN) + HYBRID_GT_MAX];
+    int len = element_length_in_bytes(PT);
+    if (len > HYBRID_GT_MAX)
+    {
+        hybrid_fail("GT element too large for HybridKey");
+    }
+    memcpy(buffer, HYBRID_DOMAIN, sizeof(HYBRID_DOMAIN));
+    element_to_bytes(buffer + sizeof(HYBRID_DOMAIN), PT);
+    if (EVP_Digest(buffer, sizeof(HYBRID_DOMAIN) + len, key, NULL, EVP_sha256(), NULL) != 1)
+    {
+        hybrid_fail("SHA-256 failed");
+    }
+}
+
+void HybridSealInit(HybridStream &stream, const unsigned char *key, unsigned char *header)
+{
+    hybrid_init(stream, key, 1);
+    if (RAND_bytes(stream.prefix, HYBRID_NONCE_PREFIX_LEN) != 1)
+    {
+        hybrid_fail("RAND_bytes failed");
+    }
+    header[0] = HYBRID_VERSION;
+    memcpy(header + 1, stream.prefix, HYBRID_NONCE_PREFIX_LEN);
+}
+
+int HybridOpenInit(HybridStream &stream, const unsigned char *key, const unsigned char *header)
+{
+    if (header[0] != HYBRID_VERSION)
+    {
+        stream.ctx = NULL;
+        return 0;
+    }
+    hybrid_init(stream, key, 0);
+    memcpy(stream.prefix, header + 1, HYBRID_NONCE_PREFIX_LEN);
+    return 1;
+}
+
+void HybridStreamClear(HybridStream &stream)
+{
+    EVP_CIPHER_CTX_free(stream.ctx);
+    stream.ctx = NULL;
+}
+
+size_t HybridSealChunk(HybridStream &stream, const unsigned char *in, size_t in_len, int final, unsigned char *out)
+{
+    if (stream.done || in_len > HYBRID_CHUNK || stream.counter == UINT32_MAX)
+    {
+        hybrid_fail("HybridSealChunk past the end of the stream");
+    }
+
+    unsigned char nonce[HYBRID_NONCE_PREFIX_LEN + 4];
+    int len;
+    hybrid_put32(out, (uint32_t)in_len | (final ? HYBRID_FINAL : 0));
+    hybrid_nonce(stream, nonce);
+    if (EVP_EncryptInit_ex(stream.ctx, NULL, NULL, NULL, nonce) != 1
+        || EVP_EncryptUpdate(stream.ctx, NULL, &len, out, 4) != 1
+        || EVP_EncryptUpdate(stream.ctx, out + 4, &len, in, (int)in_len) != 1
+        || EVP_EncryptFinal_ex(stream.ctx, out + 4 + in_len, &len) != 1
+        || EVP_CIPHER_CTX_ctrl(stream.ctx, EVP_CTRL_GCM_GET_TAG, HYBRID_TAG_LEN, out + 4 + in_len) != 1)
+    {
+        hybrid_fail("AES-256-GCM seal failed");
+    }
+
+    stream.counter++;
+    stream.done = final;
+    return in_len + HYBRID_RECORD_OVERHEAD;
+}
+
+// On -1 out may hold unauthenticated bytes and must be discarded
+long HybridOpenChunk(HybridStream &stream, const unsigned char *record, size_t record_len, unsigned char *out)
+{
+    if (stream.done || record_len < HYBRID_RECORD_OVERHEAD || stream.counter == UINT32_MAX)
+    {
+        return -1;
+    }
+    uint32_t field = hybrid_get32(record);
+    size_t in_len = field & ~HYBRID_FINAL;
+    if (in_len > HYBRID_CHUNK || record_len != in_len + HYBRID_RECORD_OVERHEAD)
+    {
+        return -1;
+    }
+
+    unsigned char nonce[HYBRID_NONCE_PREFIX_LEN + 4];
+    int len;
+    hybrid_nonce(stream, nonce);
+    if (EVP_DecryptInit_ex(stream.ctx, NULL, NULL, NULL, nonce) != 1
+        || EVP_DecryptUpdate(stream.ctx, NULL, &len, record, 4) != 1
+        || EVP_DecryptUpdate(stream.ctx, out, &len, record + 4, (int)in_len) != 1
+        || EVP_CIPHER_CTX_ctrl(stream.ctx, EVP_CTRL_GCM_SET_TAG, HYBRID_TAG_LEN, (void *)(record + 4 + in_len)) != 1
+        || EVP_DecryptFinal_ex(stream.ctx, out + in_len, &len) != 1)
+    {
+        return -1;
+    }
+
+    stream.counter++;
+    stream.done = (field & HYBRID_FINAL) != 0;
+    return (long)in_len;
+}
+
+
+int HybridEncryptFile(const unsigned char *key, FILE *in, FILE *out)
+{
+    HybridStream stream;
+    unsigned char header[HYBRID_HEADER_LEN];
+    unsigned char *chunk = (unsigned char *)malloc(HYBRID_CHUNK);
+    unsigned char *record = (unsigned char *)malloc(HYBRID_RECORD_MAX);
+    if (!chunk || !record)
+    {
+        hybrid_fail("Memory allocation failed");
+    }
+
+    HybridSealInit(stream, key, header);
+    int ok = fwrite(header, 1, HYBRID_HEADER_LEN, out) == HYBRID_HEADER_LEN;
+    while (ok)
+    {
+        size_t n = fread(chunk, 1, HYBRID_CHUNK, in);
+        if (ferror(in))
+        {
+            ok = 0;
+            break;
+        }
+        // a full chunk is final only if nothing follows it
+        int final = 1;
+        if (n == HYBRID_CHUNK)
+        {
+            int c = fgetc(in);
+            if (c != EOF)
+            {
+                ungetc(c, in);
+                final = 0;
+            }
+        }
+        size_t record_len = HybridSealChunk(stream, chunk, n, final, record);
+        ok = fwrite(record, 1, record_len, out) == record_len;
+        if (final)
+        {
+            break;
+        }
+    }
+
+    HybridStreamClear(stream);
+    free(chunk);
+    free(record);
+    return ok;
+}
+
+// Plaintext is written as records authenticate, a 0 return invalidates everything written
+int HybridDecryptFile(const unsigned char *key, FILE *in, FILE *out)
+{
+    HybridStream stream;
+    unsigned char header[HYBRID_HEADER_LEN];
+    if (fread(header, 1, HYBRID_HEADER_LEN, in) != HYBRID_HEADER_LEN || !HybridOpenInit(stream, key, header))
+    {
+        return 0;
+    }
+    unsigned char *chunk = (unsigned char *)malloc(HYBRID_CHUNK);
+    unsigned char *record = (unsigned char *)malloc(HYBRID_RECORD_MAX);
+    if (!chunk || !record)
+    {
+        hybrid_fail("Memory allocation failed");
+    }
+
+    int ok = 1;
+    while (ok && !stream.done)
+    {
+        if (fread(record, 1, 4, in) != 4)
+        {
+            ok = 0;
+            break;
+        }
+        size_t in_len = hybrid_get32(record) & ~HYBRID_FINAL;
+        if (in_len > HYBRID_CHUNK || fread(record + 4, 1, in_len + HYBRID_TAG_LEN, in) != in_len + HYBRID_TAG_LEN)
+        {
+            ok = 0;
+            break;
+        }
+        long n = HybridOpenChunk(stream, record, in_len + HYBRID_RECORD_OVERHEAD, chunk);
+        ok = n >= 0 && fwrite(chunk, 1, (size_t)n, out) == (size_t)n;
+    }
+    // nothing may follow the final record
+    if (ok && fgetc(in) != EOF)
+    {
+        ok = 0;
+    }
+
+    HybridStreamClear(stream);
+    free(chunk);
+    free(record);
+    return ok;
+}
@@ -0,0 +1,145 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Description: Benchmark harness, monotonic clock, warm-up, adaptive iterations and JSON/CSV output.
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: dongziyics@gmail.com
+ */
+
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Warm-up runs the body for at least this long before anything is recorded
+#define BENCH_WARMUP_NS 20000000ULL
+// Calls are batched so one sample lasts at least this long, which keeps the
+// clock read out of the per-call time of nanosecond operations
+#define BENCH_SAMPLE_NS 50000ULL
+// Samples are taken until this much time is spent and at least BENCH_MIN_SAMPLES exist
+#define BENCH_TARGET_NS 250000000ULL
+#define BENCH_MIN_SAMPLES 5
+#define BENCH_MAX_SAMPLES 10000
+
+typedef enum BenchUnit
+{
+    BENCH_UNIT_NS,
+    BENCH_UNIT_BYTES,
+    BENCH_UNIT_COUNT
+} BenchUnit;
+
+// Op-name registry, the name is the stable key in the JSON/CSV output
+typedef enum BenchOp
+{
+    // group and field arithmetic
+    BENCH_POINT_MUL_G1,
+    BENCH_POINT_ADD_G1,
+    BENCH_POINT_INV_G1,
+    BENCH_POW_G1,
+    BENCH_POW_G2,
+    BENCH_ADD_ZR,
+    BENCH_SUB_ZR,
+    BENCH_MUL_ZR,
+    BENCH_DIV_ZR,
+    BENCH_INV_ZR,
+    BENCH_MUL_GT,
+    BENCH_DIV_GT,
+    BENCH_POW_GT,
+    BENCH_PAIRING,
+    BENCH_TWO_PAIRINGS,
+    BENCH_PROD_PAIRING,
+    // hashing and encoding
+    BENCH_ID_TO_ZR,
+    BENCH_BYTES_TO_G1,
+    BENCH_G2_TO_ZR,
+    BENCH_HASH_SHA256,
+    BENCH_HASH_SHA256_32,
+    BENCH_HASH_SHA256_32_CHAINS,
+    BENCH_HYBRID_SEAL,
+    BENCH_HYBRID_OPEN,
+    // signatures
+    BENCH_WOTS_KEYGEN,
+    BENCH_WOTS_SIGN,
+    BENCH_WOTS_VERIFY,
+    // scheme operations
+    BENCH_CCA_KEYGEN,
+    BENCH_CCA_TRAPDOOR,
+    BENCH_CCA_ENC,
+    BENCH_CCA_RKGEN,
+    BENCH_CCA_RJGEN,
+    BENCH_CCA_REENC,
+    BENCH_CCA_DEC1,
+    BENCH_CCA_DEC2,
+    BENCH_CCA_SENDER_DEC,
+    // end-to-end stages of the robust tests
+    BENCH_SENDER_KEYGEN,
+    BENCH_RECEIVER_KEYGEN,
+    BENCH_SENDER_ENC,
+    BENCH_RK_RJ_GEN,
+    BENCH_REENC_STAGE,
+    BENCH_RECEIVER_DEC,
+    BENCH_SENDER_DEC,
+    // sizes and counts
+    BENCH_G1_BYTES,
+    BENCH_G2_BYTES,
+    BENCH_GT_BYTES,
+    BENCH_CIPHERTEXT_BYTES,
+    BENCH_RECIPHERTEXT_BYTES,
+    BENCH_REDELTA_BYTES,
+    BENCH_RJ_BYTES,
+    BENCH_ALLOCS_WARM,
+    BENCH_ALLOCS_COLD,
+    BENCH_OP_COUNT
+} BenchOp;
+
+const char *BenchOpName(BenchOp op);
+
+BenchUnit BenchOpUnit(BenchOp op);
+
+// One row of the report. For BENCH_UNIT_NS the statistics are per unit of work
+// over the samples, each sample the mean of one batch of calls. Values recorded
+// with BenchRecordValue have one sample and no spread.
+typedef struct BenchResult
+{
+    BenchOp op;
+    std::string context;        // curve, test size, ... the row belongs to
+    long iterations;            // calls timed, warm-up excluded
+    int samples;
+    double median, p99, mean, stddev, min;
+} BenchResult;
+
+typedef struct BenchReport
+{
+    std::string suite;
+    std::vector<BenchResult> results;
+} BenchReport;
+
+uint64_t BenchNowNs();
+
+// Warms body up, then times it in batches until BENCH_TARGET_NS. body does work
+// units per call (hashes, records, ...), the statistics are per unit.
+void BenchRun(BenchReport &report, BenchOp op, const char *context, const std::function<void()> &body, int work = 1);
+
+// A single timed call, for stages that consume state and cannot be repeated
+void BenchRunOnce(BenchReport &report, BenchOp op, const char *context, const std::function<void()> &body, int work = 1);
+
+// Samples the caller timed itself, in ns per work units each
+void BenchRecordSamples(BenchReport &report, BenchOp op, const char *context, const double *samples_ns, int count, int work = 1);
+
+void BenchRecordValue(BenchReport &report, BenchOp op, const char *context, double value);
+
+// One line per result on stdout
+void BenchPrint(BenchReport &report);
+
+// Writes path_prefix.json and path_prefix.csv, returns 0 if either cannot be written
+int BenchWrite(BenchReport &report, const char *path_prefix);
+
+
+#endif
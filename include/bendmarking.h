@@ -12,7 +12,8 @@
 #ifndef BENDMARKING_H
 #define BENDMARKING_H
 
-int bendmarking();
+// Primitive costs on the curve in param_file
+int bendmarking(const char *param_file);
 
 
 #endif
\ No newline at end of file
@@ -15,11 +15,23 @@
 #include "ccastruct.h"
 #include "cpastruct.h"
 
-void ccaDec1(pairing_t pairing, UserPrivateKey User_Priv, ccaRj rj, element_t& X);
+void ccaDec1(pairing_t pairing, UserPrivateKey &User_Priv, ccaRj &rj, element_t& X);
 
-void ccaDec2(pairing_t pairing, UserPrivateKey User_Priv, ccaReCiphertext RCT, TimeTrapDoor St , ccaRj rj, element_t X, element_t& PT_Bob);
+void ccaDec2(pairing_t pairing, UserPrivateKey &User_Priv, ccaReCiphertext &RCT, TimeTrapDoor &St , ccaRj &rj, element_t X, element_t& PT_Bob);
 
-void ccaSenderDec(pairing_t pairing, pkg_params pkg_params, ts_params ts_params, UserPrivateKey User_Alice_Priv, TimeTrapDoor St, ccaCiphertext PCT, element_t &PT_Alice);
+void ccaSenderDec(pairing_t pairing, pkg_params &pkg_params, ts_params &ts_params, UserPrivateKey &User_Alice_Priv, TimeTrapDoor &St, ccaCiphertext &PCT, element_t &PT_Alice);
+
+// Same as above with keys prepared once by PrepareUserPrivateKey / PrepareTimeTrapDoor
+void ccaDec1(pairing_t pairing, PreparedUserPrivateKey &User_Priv, ccaRj &rj, element_t& X);
+
+void ccaDec2(pairing_t pairing, PreparedUserPrivateKey &User_Priv, ccaReCiphertext &RCT, PreparedTimeTrapDoor &St , ccaRj &rj, element_t X, element_t& PT_Bob);
+
+void ccaSenderDec(pairing_t pairing, PreparedUserPrivateKey &User_Alice_Priv, PreparedTimeTrapDoor &St, ccaCiphertext &PCT, element_t &PT_Alice);
+
+// ccaDec2 on the stored PCT plus a ccaReEncDelta output, returns 0 without decrypting if Delta.ref does not match PCT
+int ccaDec2Delta(pairing_t pairing, UserPrivateKey &User_Priv, ccaCiphertext &PCT, ccaReDelta &Delta, TimeTrapDoor &St , ccaRj &rj, element_t X, element_t& PT_Bob);
+
+int ccaDec2Delta(pairing_t pairing, PreparedUserPrivateKey &User_Priv, ccaCiphertext &PCT, ccaReDelta &Delta, PreparedTimeTrapDoor &St , ccaRj &rj, element_t X, element_t& PT_Bob);
 
 
 #endif
\ No newline at end of file
@@ -17,9 +17,22 @@
 #include "cpastruct.h"
 #include "pbc.h"
 
-void ccaEnc(pairing_t pairing, pkg_params pkg_params, ts_params ts_params, element_t user_Alice_Pub, UserPrivateKey User_Alice_Priv, element_t Time_Pub, element_t vk, element_t PT, ccaCiphertext &PCT);
+void ccaEnc(pairing_t pairing, pkg_params &pkg_params, ts_params &ts_params, element_t user_Alice_Pub, UserPrivateKey &User_Alice_Priv, element_t Time_Pub, element_t vk, element_t PT, ccaCiphertext &PCT);
 
-void ccaReEnc(pairing_t pairing, ccaCiphertext PCT, element_t rk, pkg_params pkg_params, element_t vk, ccaReCiphertext &RCT);
+void ccaReEnc(pairing_t pairing, ccaCiphertext &PCT, element_t rk, pkg_params &pkg_params, element_t vk, ccaReCiphertext &RCT);
+
+// ccaReEnc emitting only RK2, C32 and the ccaCiphertextDigest of PCT, see ccaDec2Delta
+void ccaReEncDelta(pairing_t pairing, ccaCiphertext &PCT, element_t rk, pkg_params &pkg_params, element_t vk, ccaReDelta &Delta);
+
+// Smallest batch for which ccaReEncBatch preprocesses g and rk (symmetric pairings only)
+#define CCA_REENC_PP_MIN 16
+
+// ccaReEnc / ccaReEncDelta of PCT[i] with vk[i] for ciphertext_number ciphertexts under one rk,
+// RCT[i] / Delta[i] must be initialised. rk must come from ccaRkGenBatch over the same PCT[],
+// an rk from ccaRkGen only serves the one ciphertext it was made for.
+void ccaReEncBatch(pairing_t pairing, ccaCiphertext PCT[], int ciphertext_number, element_t rk, pkg_params &pkg_params, element_t vk[], ccaReCiphertext RCT[]);
+
+void ccaReEncDeltaBatch(pairing_t pairing, ccaCiphertext PCT[], int ciphertext_number, element_t rk, pkg_params &pkg_params, element_t vk[], ccaReDelta Delta[]);
 
 
 #endif
\ No newline at end of file
@@ -17,12 +17,26 @@
 #include "ccastruct.h"
 #include "cpastruct.h"
 
-void ccaPrivatekeyGen(pairing_t pairing, element_t pkg_priv, pkg_params pkg_params, element_t user_Alice_Pub, UserPrivateKey &privatekey);
+void ccaPrivatekeyGen(pairing_t pairing, element_t pkg_priv, pkg_params &pkg_params, element_t user_Alice_Pub, UserPrivateKey &privatekey);
 
-void ccaTimeTrapDoorGen(pairing_t pairing, element_t ts_priv, ts_params ts_params, element_t Time_Pub, TimeTrapDoor &Time_St);
+void ccaTimeTrapDoorGen(pairing_t pairing, element_t ts_priv, ts_params &ts_params, element_t Time_Pub, TimeTrapDoor &Time_St);
 
-void ccaRkGen(pairing_t pairing, pkg_params pkg_params, element_t user_Alice_Pub, UserPrivateKey User_Alice_Priv, ccaCiphertext PCT, element_t &rk, element_t &X);
+void ccaRkGen(pairing_t pairing, UserPrivateKey &User_Alice_Priv, ccaCiphertext &PCT, element_t &rk, element_t &X);
 
-void ccaRjGen(pairing_t pairing, pkg_params pkg_params, UserPrivateKey User_Alice_Priv, element_t user_Pub, element_t rk, element_t X, element_t k3, ccaRj &rj);
+// ccaRkGen for ciphertext_number ciphertexts sharing one Q^r: a single rk for the batch and
+// X[i] = e(PCT[i].C3, Q^r). An rk is bound to the C3 it was made for through X, so this is the
+// rk for ccaReEncBatch / ccaReEncDeltaBatch, and output i decrypts with an Rj built from X[i].
+void ccaRkGenBatch(pairing_t pairing, UserPrivateKey &User_Alice_Priv, ccaCiphertext PCT[], int ciphertext_number, element_t rk, element_t X[]);
+
+void ccaRjGen(pairing_t pairing, pkg_params &pkg_params, element_t user_Pub, element_t X, element_t k3, ccaRj &rj);
+
+// Receiver independent part of ccaRjGen: shared.u = g1^k3, shared.v and shared.w as in every rj
+void ccaRjSharedGen(pkg_params &pkg_params, element_t X, element_t k3, ccaRj &shared);
+
+// ccaRjGen for user_Pub[begin..end) from the terms of ccaRjSharedGen, safe to call on disjoint ranges from several threads
+void ccaRjGenRange(pairing_t pairing, pkg_params &pkg_params, ccaRj &shared, element_t user_Pub[], element_t k3, int begin, int end, ccaRj rj[]);
+
+// ccaRjGen for receiver_number receivers sharing k3, rj[i] is filled for user_Pub[i]
+void ccaRjGenBatch(pairing_t pairing, pkg_params &pkg_params, element_t user_Pub[], int receiver_number, element_t X, element_t k3, ccaRj rj[]);
 
 #endif
\ No newline at end of file
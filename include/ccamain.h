@@ -12,6 +12,7 @@
 #ifndef CCAMAIN_H
 #define CCAMAIN_H
 
-int ccamain();
+// Runs the scheme end to end on the curve in param_file
+int ccamain(const char *param_file);
 
 #endif
\ No newline at end of file
@@ -17,5 +17,11 @@
 
 void ccaid_to_zr(pairing_t pairing, const char *id, element_t &upk);
 
+// Largest serialized element ccaCiphertextDigest accepts
+#define CCA_DIGEST_ELEMENT_MAX 1024
+
+// SHA-256 of C1 || ... || C6, each serialized with element_to_bytes, no heap allocation
+void ccaCiphertextDigest(ccaCiphertext &PCT, unsigned char *digest);
+
 
 #endif
\ No newline at end of file
@@ -28,6 +28,17 @@ typedef struct ccaReCiphertext
     element_t C1, C2, C3, C4, C5, C6, RK2, C32;
 } ccaReCiphertext;
 
+// Length of ccaReDelta.ref, a ccaCiphertextDigest
+#define CCA_REF_LEN 32
+
+// Re-encryption delta: the ccaReCiphertext components that differ from the
+// original ciphertext, which ref identifies
+typedef struct ccaReDelta
+{
+    unsigned char ref[CCA_REF_LEN];
+    element_t RK2, C32;
+} ccaReDelta;
+
 // Rj structure
 typedef struct ccaRj
 {
@@ -0,0 +1,77 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: dongziyics@gmail.com
+ */
+
+
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <stddef.h>
+
+#include "pbc.h"
+#include "cpastruct.h"
+#include "ccastruct.h"
+
+// Wire format, all integers big-endian:
+//   version (1 byte) | type (1 byte) | field count (1 byte)
+//   then per field: length (2 bytes) | element bytes
+// G1/G2 fields are written with element_to_bytes_compressed, the decoder tells the
+// two forms apart by the length prefix, an empty G1/G2 field is the point at infinity.
+// GT fields are always written in full.
+// ccaReDelta carries its ref as a leading 32-byte field.
+#define CODEC_VERSION 1
+#define CODEC_HEADER_LEN 3
+
+typedef enum CodecType
+{
+    CODEC_CIPHERTEXT = 1,
+    CODEC_RECIPHERTEXT,
+    CODEC_RJ,
+    CODEC_CCA_CIPHERTEXT,
+    CODEC_CCA_RECIPHERTEXT,
+    CODEC_CCA_RJ,
+    CODEC_CCA_REDELTA
+} CodecType;
+
+// ...EncodedLength returns the exact size ...Encode will write.
+// ...Encode writes into out and returns the length, or 0 if out_len is too small.
+// ...Decode reads the elements straight from in into the initialised struct and
+// returns 1, or 0 if in is not a well-formed encoding of that type or carries a
+// G1/G2 point off the curve or outside the order-r subgroup, or a GT value outside it.
+
+size_t CiphertextEncodedLength(pairing_t pairing, Ciphertext &CT);
+size_t CiphertextEncode(pairing_t pairing, Ciphertext &CT, unsigned char *out, size_t out_len);
+int CiphertextDecode(pairing_t pairing, const unsigned char *in, size_t in_len, Ciphertext &CT);
+
+size_t ReCiphertextEncodedLength(pairing_t pairing, ReCiphertext &RCT);
+size_t ReCiphertextEncode(pairing_t pairing, ReCiphertext &RCT, unsigned char *out, size_t out_len);
+int ReCiphertextDecode(pairing_t pairing, const unsigned char *in, size_t in_len, ReCiphertext &RCT);
+
+size_t RjEncodedLength(pairing_t pairing, Rj &rj);
+size_t RjEncode(pairing_t pairing, Rj &rj, unsigned char *out, size_t out_len);
+int RjDecode(pairing_t pairing, const unsigned char *in, size_t in_len, Rj &rj);
+
+size_t ccaCiphertextEncodedLength(pairing_t pairing, ccaCiphertext &CT);
+size_t ccaCiphertextEncode(pairing_t pairing, ccaCiphertext &CT, unsigned char *out, size_t out_len);
+int ccaCiphertextDecode(pairing_t pairing, const unsigned char *in, size_t in_len, ccaCiphertext &CT);
+
+size_t ccaReCiphertextEncodedLength(pairing_t pairing, ccaReCiphertext &RCT);
+size_t ccaReCiphertextEncode(pairing_t pairing, ccaReCiphertext &RCT, unsigned char *out, size_t out_len);
+int ccaReCiphertextDecode(pairing_t pairing, const unsigned char *in, size_t in_len, ccaReCiphertext &RCT);
+
+size_t ccaRjEncodedLength(pairing_t pairing, ccaRj &rj);
+size_t ccaRjEncode(pairing_t pairing, ccaRj &rj, unsigned char *out, size_t out_len);
+int ccaRjDecode(pairing_t pairing, const unsigned char *in, size_t in_len, ccaRj &rj);
+
+size_t ccaReDeltaEncodedLength(pairing_t pairing, ccaReDelta &Delta);
+size_t ccaReDeltaEncode(pairing_t pairing, ccaReDelta &Delta, unsigned char *out, size_t out_len);
+int ccaReDeltaDecode(pairing_t pairing, const unsigned char *in, size_t in_len, ccaReDelta &Delta);
+
+
+#endif
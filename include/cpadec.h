@@ -15,13 +15,20 @@
 #include "pbc.h"
 #include "cpastruct.h"
 
-void SenderDec(pairing_t pairing, pkg_params pkg_params, ts_params ts_params, UserPrivateKey User_Alice_Priv, TimeTrapDoor St, Ciphertext PCT, element_t &PT_Alice);
+void SenderDec(pairing_t pairing, pkg_params &pkg_params, ts_params &ts_params, UserPrivateKey &User_Alice_Priv, TimeTrapDoor &St, Ciphertext &PCT, element_t &PT_Alice);
 
 // Dec1 decryption function
-void Dec1(pairing_t pairing, UserPrivateKey User_Priv, Rj rj, element_t& X);
+void Dec1(pairing_t pairing, UserPrivateKey &User_Priv, Rj &rj, element_t& X);
 
 
-void Dec2(pairing_t pairing, UserPrivateKey User_Priv, ReCiphertext RCT, TimeTrapDoor St , Rj rj, element_t X, element_t& PT_Bob);
+void Dec2(pairing_t pairing, UserPrivateKey &User_Priv, ReCiphertext &RCT, TimeTrapDoor &St , Rj &rj, element_t X, element_t& PT_Bob);
+
+// Same as above with keys prepared once by PrepareUserPrivateKey / PrepareTimeTrapDoor
+void SenderDec(pairing_t pairing, PreparedUserPrivateKey &User_Alice_Priv, PreparedTimeTrapDoor &St, Ciphertext &PCT, element_t &PT_Alice);
+
+void Dec1(pairing_t pairing, PreparedUserPrivateKey &User_Priv, Rj &rj, element_t& X);
+
+void Dec2(pairing_t pairing, PreparedUserPrivateKey &User_Priv, ReCiphertext &RCT, PreparedTimeTrapDoor &St , Rj &rj, element_t X, element_t& PT_Bob);
 
 
 #endif
\ No newline at end of file
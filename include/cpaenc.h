@@ -15,9 +15,9 @@
 #include "pbc.h"
 #include "cpastruct.h"
 
-void Enc(pairing_t pairing, pkg_params pkg_params, ts_params ts_params, element_t user_Alice_Pub, UserPrivateKey User_Alice_Priv, element_t Time_Pub, element_t PT, Ciphertext &PCT);
+void Enc(pairing_t pairing, pkg_params &pkg_params, ts_params &ts_params, element_t user_Alice_Pub, UserPrivateKey &User_Alice_Priv, element_t Time_Pub, element_t PT, Ciphertext &PCT);
 
-void ReEnc(pairing_t pairing, Ciphertext PCT, element_t rk, ReCiphertext &RCT);
+void ReEnc(pairing_t pairing, Ciphertext &PCT, element_t rk, ReCiphertext &RCT);
 
 
 
@@ -15,13 +15,22 @@
 #include "pbc.h"
 #include "cpastruct.h"
 
-void PrivatekeyGen(pairing_t pairing, element_t pkg_priv, pkg_params pkg_params, element_t user_Alice_Pub, UserPrivateKey &privatekey);
+void PrivatekeyGen(pairing_t pairing, element_t pkg_priv, pkg_params &pkg_params, element_t user_Alice_Pub, UserPrivateKey &privatekey);
 
-void TimeTrapDoorGen(pairing_t pairing, element_t ts_priv, ts_params ts_params, element_t Time_Pub, TimeTrapDoor &Time_St);
+void TimeTrapDoorGen(pairing_t pairing, element_t ts_priv, ts_params &ts_params, element_t Time_Pub, TimeTrapDoor &Time_St);
 
-void RkGen(pairing_t pairing, pkg_params pkg_params, element_t user_Alice_Pub, UserPrivateKey User_Alice_Priv, Ciphertext PCT, element_t &rk, element_t &X);
+void RkGen(pairing_t pairing, pkg_params &pkg_params, element_t user_Alice_Pub, UserPrivateKey &User_Alice_Priv, Ciphertext &PCT, element_t &rk, element_t &X);
 
-void RjGen(pairing_t pairing, pkg_params pkg_params, UserPrivateKey User_Alice_Priv, element_t user_Pub, element_t rk, element_t X, element_t k3, Rj &rj);
+void RjGen(pairing_t pairing, pkg_params &pkg_params, UserPrivateKey &User_Alice_Priv, element_t user_Pub, element_t rk, element_t X, element_t k3, Rj &rj);
+
+// Receiver independent part of RjGen: shared.u = g1^k3, shared.v and shared.w as in every rj
+void RjSharedGen(pkg_params &pkg_params, element_t X, element_t k3, Rj &shared);
+
+// RjGen for user_Pub[begin..end) from the terms of RjSharedGen
+void RjGenRange(pairing_t pairing, pkg_params &pkg_params, Rj &shared, element_t user_Pub[], element_t k3, int begin, int end, Rj rj[]);
+
+// RjGen for receiver_number receivers sharing k3, rj[i] is filled for user_Pub[i]
+void RjGenBatch(pairing_t pairing, pkg_params &pkg_params, element_t user_Pub[], int receiver_number, element_t X, element_t k3, Rj rj[]);
 
 
 #endif
\ No newline at end of file
@@ -15,16 +15,36 @@
 
 #include "pbc.h"
 
+// Ownership: the caller initialises and clears every element of these structs
+// (and of ccastruct.h). Scheme functions borrow them by reference, read the
+// inputs in place and write only their output arguments.
+
+// Group layout of the CCA scheme, so it also runs on asymmetric (Type-3) pairings:
+//   G1: g, g1, C1, C3, u
+//   G2: g2, h, K (user key and time trapdoor), C6, rk, RK1, RK2
+//   GT: e_g_g = e(g, g2), e_g_h = e(g, h) and the remaining components
+// Every pairing takes its first argument from G1. On a symmetric pairing g2 = g,
+// see ParamsG2Generator. The CPA scheme keeps everything in G1 and needs a
+// symmetric pairing.
+
 // PKG parameters stucture
 typedef struct pkg_params
 {
     element_t g, g1, h, e_g_g, e_g_h;
+    element_t g2;                   // G2 generator, see ParamsG2Generator
+    element_t e_g_h_inv;            // e(g,h)^-1, see PkgParamsPrecompute
+    element_pp_t g_pp, g1_pp, g2_pp;    // fixed-base tables, see PkgParamsPrecompute
+    element_pp_t e_g_g_pp, e_g_h_inv_pp;
 } pkg_params;
 
 //  TS parameters structure
 typedef struct ts_params
 {
     element_t g, g1, h, e_g_g, e_g_h;
+    element_t g2;                   // G2 generator, see ParamsG2Generator
+    element_t e_g_h_inv;            // e(g,h)^-1, see TsParamsPrecompute
+    element_pp_t g_pp, g1_pp, g2_pp;    // fixed-base tables, see TsParamsPrecompute
+    element_pp_t e_g_g_pp, e_g_h_inv_pp;
 } ts_params;
 
 // User private key structure
@@ -39,6 +59,20 @@ typedef struct TimeTrapDoor
     element_t r, K;
 } TimeTrapDoor;
 
+// User private key with pairing preprocessing on K, see PrepareUserPrivateKey
+typedef struct PreparedUserPrivateKey
+{
+    element_ptr r;                  // borrowed from the UserPrivateKey
+    pairing_pp_t K;
+} PreparedUserPrivateKey;
+
+// TimeTrapDoor with pairing preprocessing on K, see PrepareTimeTrapDoor
+typedef struct PreparedTimeTrapDoor
+{
+    element_ptr r;                  // borrowed from the TimeTrapDoor
+    pairing_pp_t K;
+} PreparedTimeTrapDoor;
+
 // Ciphertext structure
 typedef struct Ciphertext
 {
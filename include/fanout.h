@@ -0,0 +1,41 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: dongziyics@gmail.com
+ */
+
+
+#ifndef FANOUT_H
+#define FANOUT_H
+
+#include <functional>
+
+#include "pbc.h"
+#include "ccastruct.h"
+#include "cpastruct.h"
+#include "wots.h"
+
+// Number of workers used for a request of threads, threads <= 0 means all cores
+int FanoutThreads(int threads);
+
+// Run fn(worker, begin, end) over [0, n) in chunks of chunk items on up to threads workers.
+// Each worker drains its own deque of chunks and then steals from the others, worker is in [0, FanoutThreads(threads)).
+// There is no persistent pool: the calling thread is worker 0 and the others are spawned and joined
+// on every call, so keep n large enough that a call outweighs a thread start.
+void FanoutParallelFor(int n, int chunk, int threads, const std::function<void(int worker, int begin, int end)> &fn);
+
+// ccaPrivatekeyGen for user_Pub[0..receiver_number), privatekey[i] must be initialised
+void ccaPrivatekeyGenParallel(pairing_t pairing, element_t pkg_priv, pkg_params &pkg_params, element_t user_Pub[], int receiver_number, UserPrivateKey privatekey[], int threads);
+
+// ccaRjGenBatch spread over threads workers, rj[i] must be initialised
+void ccaRjGenParallel(pairing_t pairing, pkg_params &pkg_params, element_t user_Pub[], int receiver_number, element_t X, element_t k3, ccaRj rj[], int threads);
+
+// wots_keygen_batch over all batch.count keys, spread over threads workers
+void wots_keygen_parallel(WotsKeyBatch &batch, const uint8_t *sk_seed, int threads);
+
+
+#endif
@@ -15,6 +15,35 @@
 #include <stddef.h>
 #include <stdint.h>
 
+typedef enum Sha256Kernel {
+    SHA256_KERNEL_SCALAR,
+    SHA256_KERNEL_SHANI,
+    SHA256_KERNEL_AVX2
+} Sha256Kernel;
+
 void hash_sha256(const uint8_t *input, size_t inlen, uint8_t *out);
 
+// Kernel behind the 32-byte functions below. The fastest one the CPU runs is picked at
+// start-up unless the ECR_SHA256_KERNEL environment variable names another (scalar, shani, avx2).
+Sha256Kernel hash_sha256_kernel();
+
+// Switches the 32-byte functions to kernel, returns 0 and keeps the current one if the CPU
+// cannot run it. Not thread safe, meant for tests and benchmarks that cover every kernel.
+int hash_sha256_set_kernel(Sha256Kernel kernel);
+
+// SHA256 of exactly 32 bytes, one compress with the padding block fixed in advance.
+// out may equal in.
+void hash_sha256_32(uint8_t *out, const uint8_t *in);
+
+// SHA256(in || index), in is 32 bytes and index is 4 bytes big-endian. Still one block.
+void hash_sha256_32_indexed(uint8_t *out, const uint8_t *in, uint32_t index);
+
+// Hashes n independent 32-byte inputs, out[i] = SHA256(in[i]). out[i] may equal in[i].
+// Uses SHA extensions or 8 AVX2 lanes when the CPU has them, a portable kernel otherwise.
+void hash_sha256_32_multi(uint8_t *const out[], const uint8_t *const in[], int n);
+
+// Replaces each 32-byte buf[i] by SHA256 applied steps[i] times (0 leaves it as is).
+// A chain stays inside the kernel between steps, no byte order round trip.
+void hash_sha256_32_chains(uint8_t *const buf[], const int steps[], int n);
+
 #endif
@@ -0,0 +1,69 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: dongziyics@gmail.com
+ */
+
+
+#ifndef HYBRID_H
+#define HYBRID_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <openssl/evp.h>
+
+#include "pbc.h"
+
+// Hybrid mode: the GT plaintext PT of Enc/ccaEnc is only a key encapsulation,
+// HybridKey turns it into an AES-256-GCM key for the payload. Re-encryption and
+// Dec1/Dec2 work on the ciphertext header alone, the payload stream never changes.
+//
+// Payload stream: version (1 byte) | nonce prefix (8 bytes), then records of
+//   length (4 bytes, top bit set on the final record) | ciphertext | tag (16 bytes)
+// Record i uses nonce prefix || i and authenticates its length field, so records
+// cannot be reordered, dropped or cut off after the final one.
+#define HYBRID_VERSION 1
+#define HYBRID_KEY_LEN 32
+#define HYBRID_NONCE_PREFIX_LEN 8
+#define HYBRID_HEADER_LEN (1 + HYBRID_NONCE_PREFIX_LEN)
+#define HYBRID_TAG_LEN 16
+#define HYBRID_CHUNK (64 * 1024)
+#define HYBRID_RECORD_OVERHEAD (4 + HYBRID_TAG_LEN)
+#define HYBRID_RECORD_MAX (HYBRID_CHUNK + HYBRID_RECORD_OVERHEAD)
+#define HYBRID_FINAL 0x80000000u
+
+typedef struct HybridStream
+{
+    EVP_CIPHER_CTX *ctx;            // keyed once, only the nonce changes per record
+    unsigned char prefix[HYBRID_NONCE_PREFIX_LEN];
+    uint32_t counter;               // next record index
+    int done;                       // final record sealed or opened
+} HybridStream;
+
+// key = SHA-256(domain || PT), PT is the GT element carried by the ciphertext header
+void HybridKey(element_t PT, unsigned char *key);
+
+// Start a stream, HybridSealInit writes HYBRID_HEADER_LEN bytes to header
+void HybridSealInit(HybridStream &stream, const unsigned char *key, unsigned char *header);
+// Returns 1, or 0 if header has the wrong version
+int HybridOpenInit(HybridStream &stream, const unsigned char *key, const unsigned char *header);
+void HybridStreamClear(HybridStream &stream);
+
+// Seal at most HYBRID_CHUNK bytes into one record in out, returns the record length
+size_t HybridSealChunk(HybridStream &stream, const unsigned char *in, size_t in_len, int final, unsigned char *out);
+// Open one record into out (HYBRID_CHUNK bytes), returns the plaintext length, or -1 if the
+// record is malformed, out of order or fails authentication
+long HybridOpenChunk(HybridStream &stream, const unsigned char *record, size_t record_len, unsigned char *out);
+
+// Whole streams between files in constant memory, return 1 on success and 0 on any I/O
+// or authentication failure (a truncated stream is an authentication failure)
+int HybridEncryptFile(const unsigned char *key, FILE *in, FILE *out);
+int HybridDecryptFile(const unsigned char *key, FILE *in, FILE *out);
+
+
+#endif
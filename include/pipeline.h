@@ -0,0 +1,38 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: dongziyics@gmail.com
+ */
+
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+
+#include "pbc.h"
+#include "wots.h"
+#include "xmss.h"
+#include "ccastruct.h"
+#include "cpastruct.h"
+
+// Slots in each queue between two stages, a full queue stalls the stage feeding it
+#define PIPELINE_QUEUE_DEPTH 64
+
+// Sender side of trade_number trades as three overlapping stages:
+//   ccaEnc(PT[i]) -> PCT[i], ccaCiphertextDigest -> message[i], xmss_sign -> sig[i]
+// joined by bounded lock-free queues. Each stage runs on its own thread count
+// (<= 0 means 1), so throughput follows the slowest stage rather than the sum.
+// PCT[i] must be initialised, trades leave each stage in no particular order.
+// Each trade takes the next leaf of key, so sig[i].index follows signing order.
+void ccaSenderPipeline(pairing_t pairing, pkg_params &pkg_params, ts_params &ts_params, element_t user_Alice_Pub, UserPrivateKey &User_Alice_Priv, element_t Time_Pub, element_t vk,
+                       element_t PT[], int trade_number, XmssKey &key,
+                       ccaCiphertext PCT[], uint8_t message[][WOTS_N], XmssSignature sig[],
+                       int enc_threads, int hash_threads, int sign_threads);
+
+
+#endif
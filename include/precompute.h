@@ -0,0 +1,46 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: dongziyics@gmail.com
+ */
+
+
+#ifndef PRECOMPUTE_H
+#define PRECOMPUTE_H
+
+#include "pbc.h"
+#include "cpastruct.h"
+
+// Sets g2, initialised in G2, to the generator paired against g: g itself on a
+// symmetric pairing, an independent G2 element otherwise
+void ParamsG2Generator(pairing_t pairing, element_t g, element_t g2);
+
+// Build e(g,h)^-1 and the fixed-base tables once g, g1, g2, h, e(g,g2), e(g,h) are set
+void PkgParamsPrecompute(pkg_params &pkg_params);
+
+void TsParamsPrecompute(ts_params &ts_params);
+
+// Release the tables, call before clearing the parameter elements
+void PkgParamsPrecomputeClear(pkg_params &pkg_params);
+
+void TsParamsPrecomputeClear(ts_params &ts_params);
+
+// Miller-loop preprocessing of a long-lived key, the key must outlive the prepared copy.
+// Symmetric pairings only.
+void PrepareUserPrivateKey(pairing_t pairing, UserPrivateKey &privatekey, PreparedUserPrivateKey &prepared);
+
+void PrepareTimeTrapDoor(pairing_t pairing, TimeTrapDoor &Time_St, PreparedTimeTrapDoor &prepared);
+
+void PreparedUserPrivateKeyClear(PreparedUserPrivateKey &prepared);
+
+void PreparedTimeTrapDoorClear(PreparedTimeTrapDoor &prepared);
+
+// out = e(a1, b1) * e(a2, b2)
+void PairingProd2(element_t out, element_t a1, element_t b1, element_t a2, element_t b2, pairing_t pairing);
+
+
+#endif
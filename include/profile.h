@@ -0,0 +1,29 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Description: Per-curve cost profile of the pairing primitives and every scheme operation.
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: dongziyics@gmail.com
+ */
+
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+// Param files shipped in ../param that the scheme can serialise, the default curve list
+extern const char *const CURVE_PARAM_FILES[];
+extern const int CURVE_PARAM_COUNT;
+
+// For each param file: element sizes, pairing and exponentiation costs with the
+// pairing taken over G1 x G2, then keygen/Enc/ReEnc/Dec latency and codec sizes
+// of the ciphertexts in the group layout of cpastruct.h. Files that do not parse
+// are reported and skipped. param_files NULL profiles CURVE_PARAM_FILES.
+// Results go to curve_profile_output.json/.csv, returns 1 if every profiled curve
+// decrypted correctly.
+int curveProfile(const char *const param_files[], int count);
+
+
+#endif
@@ -0,0 +1,28 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: dongziyics@gmail.com
+ */
+
+
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include "pbc.h"
+
+// Process-wide pairing for param_file, read and initialised on first use and shared
+// by every later caller and thread. Files are told apart by their resolved path.
+// The pairing is never changed after init, so concurrent use is safe. Callers must
+// not pairing_clear it. Returns NULL after a [FAIL] line if the file is unusable.
+pairing_ptr PairingAcquire(const char *param_file);
+
+// Clears every registered pairing, and this thread's scratch arena first.
+// Call once after the last user, other threads' arenas must already be released.
+void PairingRegistryClear();
+
+
+#endif
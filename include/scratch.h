@@ -0,0 +1,75 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: dongziyics@gmail.com
+ */
+
+
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include "pbc.h"
+
+// Slots per group in one thread's arena
+#define SCRATCH_SLOTS 16
+
+typedef enum ScratchGroup
+{
+    SCRATCH_G1 = 0,
+    SCRATCH_G2,
+    SCRATCH_GT,
+    SCRATCH_ZR,
+    SCRATCH_GROUPS
+} ScratchGroup;
+
+// RAII owner of one element_t, initialised on demand and cleared on destruction
+class Element
+{
+public:
+    Element() : initialised(false) {}
+    ~Element() { Clear(); }
+    Element(const Element &) = delete;
+    Element &operator=(const Element &) = delete;
+
+    void Init(pairing_ptr pairing, ScratchGroup group);
+    void Clear();
+    bool Initialised() const { return initialised; }
+
+    element_ptr get() { return e; }
+    operator element_ptr() { return e; }
+
+private:
+    element_t e;
+    bool initialised;
+};
+
+// Stack frame on this thread's scratch arena. Temporaries borrowed from the
+// frame are handed back when it goes out of scope, frames may nest.
+// Borrowed elements hold stale values and must be written before being read.
+class ScratchFrame
+{
+public:
+    explicit ScratchFrame(pairing_ptr pairing);
+    ~ScratchFrame();
+    ScratchFrame(const ScratchFrame &) = delete;
+    ScratchFrame &operator=(const ScratchFrame &) = delete;
+
+    element_ptr G1() { return Borrow(SCRATCH_G1); }
+    element_ptr G2() { return Borrow(SCRATCH_G2); }
+    element_ptr GT() { return Borrow(SCRATCH_GT); }
+    element_ptr Zr() { return Borrow(SCRATCH_ZR); }
+
+private:
+    element_ptr Borrow(ScratchGroup group);
+    int mark[SCRATCH_GROUPS];
+};
+
+// Clear this thread's arena. Must be called before pairing_clear on the bound pairing,
+// an arena still bound when its thread exits is leaked rather than cleared.
+void ScratchArenaRelease();
+
+#endif
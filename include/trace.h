@@ -0,0 +1,119 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Description: Compile-time gated per-stage spans and primitive counters, dumped as folded stacks.
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: dongziyics@gmail.com
+ */
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+// Primitive kinds counted by TRACE_OP
+typedef enum TraceKind
+{
+    TRACE_PAIRING,
+    TRACE_PAIRING_PROD,
+    TRACE_POW_G1,
+    TRACE_POW_G2,
+    TRACE_POW_GT,
+    TRACE_HASH,
+    TRACE_KINDS
+} TraceKind;
+
+#ifdef ECR_TRACE
+
+#include <stdint.h>
+
+// Ticks are rdtsc cycles on x86 and CLOCK_MONOTONIC ns elsewhere, TraceDump converts
+uint64_t TraceNow();
+
+// Opens a span named name under the innermost open span of this thread, kind is
+// TRACE_KINDS for function and stage spans. Names must be string literals.
+void TraceEnter(const char *name, int kind);
+void TraceExit(uint64_t ticks);
+
+class TraceSpan
+{
+public:
+    TraceSpan(const char *name, int kind) { TraceEnter(name, kind); start = TraceNow(); }
+    ~TraceSpan() { TraceExit(TraceNow() - start); }
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    uint64_t start;
+};
+
+// Function span whose straight-line body is split into stages, each Stage()
+// closes the previous stage span
+class TraceFunction
+{
+public:
+    explicit TraceFunction(const char *name) : stage_start(0), in_stage(false) { TraceEnter(name, TRACE_KINDS); start = TraceNow(); }
+    ~TraceFunction()
+    {
+        uint64_t now = TraceNow();
+        if (in_stage)
+        {
+            TraceExit(now - stage_start);
+        }
+        TraceExit(now - start);
+    }
+    TraceFunction(const TraceFunction &) = delete;
+    TraceFunction &operator=(const TraceFunction &) = delete;
+
+    void Stage(const char *name)
+    {
+        if (in_stage)
+        {
+            TraceExit(TraceNow() - stage_start);
+        }
+        TraceEnter(name, TRACE_KINDS);
+        in_stage = true;
+        stage_start = TraceNow();
+    }
+
+private:
+    uint64_t start, stage_start;
+    bool in_stage;
+};
+
+// Drops everything recorded so far on every thread that has exited and on this one
+void TraceReset();
+
+// Writes path_prefix.folded, one "fn;stage;op self_ns" line per stack for
+// flamegraph.pl, and prints the span tree with time and primitive counts per node
+// to stdout. Spans of worker threads are included once the worker has exited,
+// at the top level since a worker does not inherit the caller's open spans.
+int TraceDump(const char *path_prefix);
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+// Span over the rest of the enclosing function, stages are opened with TRACE_STAGE
+#define TRACE_FUNCTION(name) TraceFunction trace_function_(name)
+#define TRACE_STAGE(name) trace_function_.Stage(name)
+// Span and count for one primitive call
+#define TRACE_OP(kind, ...) do { TraceSpan TRACE_CONCAT(trace_op_, __LINE__)(0, kind); __VA_ARGS__; } while (0)
+// The same for a primitive that is the rest of the enclosing scope
+#define TRACE_OP_SCOPE(kind) TraceSpan TRACE_CONCAT(trace_op_, __LINE__)(0, kind)
+
+#else
+
+// Disabled build: spans vanish and the primitive calls are left as written
+#define TRACE_FUNCTION(name) do { } while (0)
+#define TRACE_STAGE(name) do { } while (0)
+#define TRACE_OP(kind, ...) do { __VA_ARGS__; } while (0)
+#define TRACE_OP_SCOPE(kind) do { } while (0)
+
+static inline void TraceReset() {}
+static inline int TraceDump(const char *) { return 1; }
+
+#endif
+
+
+#endif
@@ -22,6 +22,12 @@
 #define WOTS_LEN2 3       // 可根据实际计算得到
 #define WOTS_LEN (WOTS_LEN1 + WOTS_LEN2)
 
+// Every chain value of one key, chain[i][j] = H^j(PRF(sk_seed, i)).
+// About 34 KB and as secret as sk_seed, keep it off the stack and wipe it after use.
+typedef struct WotsKeyCache {
+    uint8_t chain[WOTS_LEN][WOTS_W][WOTS_N];
+} WotsKeyCache;
+
 void wots_keygen(uint8_t pk[WOTS_LEN][WOTS_N],
                  const uint8_t *sk_seed);
 
@@ -33,4 +39,46 @@ void wots_pk_from_sig(uint8_t pk[WOTS_LEN][WOTS_N],
                       const uint8_t sig[WOTS_LEN][WOTS_N],
                       const uint8_t *message);
 
+// Compressed public key, SHA256 over the WOTS_LEN chain ends. Only these
+// WOTS_N bytes need to be stored or shipped instead of the full pk.
+void wots_pk_compress(uint8_t pk_root[WOTS_N],
+                      const uint8_t pk[WOTS_LEN][WOTS_N]);
+
+void wots_keygen_root(uint8_t pk_root[WOTS_N],
+                      const uint8_t *sk_seed);
+
+// Fills cache with every chain position while computing the root. Signing from
+// the cache is a table lookup, same signature as wots_sign with the same seed.
+// WOTS+ is one-time: a cache must sign a single message and then be wiped, two
+// signatures from one key reveal enough chain values to forge a third.
+void wots_keygen_cached(uint8_t pk_root[WOTS_N],
+                        const uint8_t *sk_seed,
+                        WotsKeyCache &cache);
+
+void wots_sign_cached(uint8_t sig[WOTS_LEN][WOTS_N],
+                      const uint8_t *message,
+                      WotsKeyCache &cache);
+
+// count keys generated together, key k has seed PRF(sk_seed, first + k) like XMSS leaves.
+// pk is structure-of-arrays, chain end c of key k at pk + WOTS_BATCH_OFFSET(c, k, count),
+// so one chain position of consecutive keys is contiguous. pk or root may be NULL.
+#define WOTS_BATCH_OFFSET(c, k, count) (((size_t)(c) * (count) + (k)) * WOTS_N)
+// Keys whose chains run through the hash together
+#define WOTS_BATCH_LANES 8
+
+typedef struct WotsKeyBatch {
+    int count;
+    uint32_t first;
+    uint8_t *pk;                // WOTS_LEN * count * WOTS_N bytes
+    uint8_t (*root)[WOTS_N];    // count compressed keys
+} WotsKeyBatch;
+
+// Keys [begin, end) of batch, WOTS_BATCH_LANES keys per multi-lane hash call
+void wots_keygen_batch(WotsKeyBatch &batch, const uint8_t *sk_seed, int begin, int end);
+
+// Recomputes the chain ends from sig and checks them against pk_root
+bool wots_verify(const uint8_t sig[WOTS_LEN][WOTS_N],
+                 const uint8_t *message,
+                 const uint8_t pk_root[WOTS_N]);
+
 #endif
@@ -0,0 +1,71 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Description: Merkle tree over WOTS keys, one published root for 2^h signatures.
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: dongziyics@gmail.com
+ */
+
+
+#ifndef XMSS_H
+#define XMSS_H
+
+#include <stdint.h>
+
+#include "wots.h"
+
+// Leaf i is the WOTS key of PRF(sk_seed, i), compressed with wots_pk_compress.
+// Inner nodes are SHA256(left || right).
+#define XMSS_MAX_HEIGHT 20
+// BDS keeps the top XMSS_BDS_K levels of right nodes from keygen instead of
+// recomputing them, height - XMSS_BDS_K must be even
+#define XMSS_BDS_K 2
+#define XMSS_RETAIN ((1 << XMSS_BDS_K) - XMSS_BDS_K - 1)
+
+typedef struct XmssTreehash {
+    int height;
+    uint32_t next_idx;
+    int stackusage;
+    int completed;
+    uint8_t node[WOTS_N];
+} XmssTreehash;
+
+// Secret and stateful: next must never repeat, persist the key after every xmss_sign
+typedef struct XmssKey {
+    int height;
+    uint32_t next;
+    uint8_t sk_seed[WOTS_N];
+    uint8_t root[WOTS_N];
+
+    // BDS traversal state, auth is the path for leaf next
+    uint8_t auth[XMSS_MAX_HEIGHT][WOTS_N];
+    uint8_t keep[XMSS_MAX_HEIGHT / 2][WOTS_N];
+    uint8_t stack[XMSS_MAX_HEIGHT + 1][WOTS_N];
+    int stacklevels[XMSS_MAX_HEIGHT + 1];
+    int stackoffset;
+    XmssTreehash treehash[XMSS_MAX_HEIGHT - XMSS_BDS_K];
+    uint8_t retain[XMSS_RETAIN > 0 ? XMSS_RETAIN : 1][WOTS_N];
+} XmssKey;
+
+typedef struct XmssSignature {
+    uint32_t index;
+    uint8_t wots_sig[WOTS_LEN][WOTS_N];
+    uint8_t auth[XMSS_MAX_HEIGHT][WOTS_N];
+} XmssSignature;
+
+// Builds the whole tree once (2^height WOTS keygens, batched on all cores) and
+// the traversal state.
+// height must be even, from XMSS_BDS_K to XMSS_MAX_HEIGHT.
+void xmss_keygen(XmssKey &key, const uint8_t *sk_seed, int height);
+
+// Signs with leaf key.next and advances the state, a few leaf computations per call.
+// Returns 0 once all 2^height leaves are used.
+int xmss_sign(XmssKey &key, XmssSignature &sig, const uint8_t *message);
+
+bool xmss_verify(const XmssSignature &sig, const uint8_t *message, const uint8_t root[WOTS_N], int height);
+
+
+#endif
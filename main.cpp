@@ -28,6 +28,9 @@
 #include "cpamaptozr.h"
 #include "ccamain.h"
 #include "pbc.h"
+#include "registry.h"
+#include "profile.h"
+#include "trace.h"
 #include "robust_receiver_test.h"
 #include "robust_trade_test.h"
 
@@ -46,8 +49,22 @@ using namespace std;
 #define ROBUST_TEST_TREADE_NUMBER_50 50
 #define ROBUST_TEST_TREADE_NUMBER_100 100
 
-int main()
+int main(int argc, char *argv[])
 {
+    // Profiler mode: ECR-TDPDS profile [param file ...], every shipped curve by default
+    if (argc > 1 && !strcmp(argv[1], "profile"))
+    {
+        int profile_result = argc > 2 ? curveProfile(argv + 2, argc - 2) : curveProfile(NULL, 0);
+        if (profile_result){
+            cout << "[PASS] Curve Profile completed successfully." << endl;
+        }
+        else{
+            cout << "[FAIL] Curve Profile failed." << endl;
+        }
+        TraceDump("curve_profile_trace");
+        PairingRegistryClear();
+        return 0;
+    }
 
     // // CPA Scheme Test
     // int cpatest;
@@ -61,7 +78,7 @@ int main()
 
     // // CCA Scheme Test
     // int ccatest;
-    // ccatest = ccamain();
+    // ccatest = ccamain("../param/a.param");
     // if (ccatest){
     //     cout << "[PASS] CCA Scheme Test completed successfully." << endl;
     // }
@@ -71,7 +88,7 @@ int main()
 
     // Bendmarking Scheme Test
     int bendmarking_result;
-    bendmarking_result = bendmarking();
+    bendmarking_result = bendmarking("../param/d201.param");
     if (bendmarking_result){
         cout << "[PASS] BendTest Scheme Test completed successfully." << endl;
     }
@@ -80,15 +97,6 @@ int main()
     }
 
     // // Robust Receiver Test
-    // FILE *robust_receiver_file;
-    // robust_receiver_file = fopen("robust_receiver_test.txt", "w");
-    // if (robust_receiver_file == NULL) {
-    //     perror("[Fail] Unable to open robust_receiver_test.txt.");
-    //     exit(1);
-    // }
-    // fprintf(robust_receiver_file, "=== Robust Receiver Test Start ===\n");
-    // fclose(robust_receiver_file);
-
     // robustReceiverTest(ROBUST_TEST_RECEIVER_NUMBER_100);
     // printf("Robustness test with 100 receivers completed.\n");
 
@@ -110,25 +118,8 @@ int main()
     // robustReceiverTest(ROBUST_TEST_RECEIVER_NUMBER_10000);
     // printf("Robustness test with 10000 receivers completed.\n");
 
-    // robust_receiver_file = fopen("robust_receiver_test.txt", "a");
-    // if (robust_receiver_file == NULL) {
-    //     perror("[Fail] Unable to open robust_receiver_test.txt.");
-    //     exit(1);
-    // }
-    // fprintf(robust_receiver_file, "=== Robust Receiver Test End ===\n");
-    // fclose(robust_receiver_file);
-
     // // Robust Trade Test
 
-    // FILE *robust_trade_file;
-    // robust_trade_file = fopen("robust_trade_test.txt", "w");
-    // if (robust_trade_file == NULL) {
-    //     perror("[Fail] Unable to open robust_trade_test.txt.");
-    //     exit(1);
-    // }
-    // fprintf(robust_trade_file, "=== Robust Trade Test Start ===\n");
-    // fclose(robust_trade_file);
-
     // robustTradeTest(ROBUST_TEST_TREADE_NUMBER_10, ROBUST_TEST_RECEIVER_NUMBER_100);
     // printf("Robustness test with 10 trade, 100 receivers completed.\n");
 
@@ -141,15 +132,13 @@ int main()
     // robustTradeTest(ROBUST_TEST_TREADE_NUMBER_100, ROBUST_TEST_RECEIVER_NUMBER_100);
     // printf("Robustness test with 100 trade, 100 receivers completed.\n");
 
-    // robust_trade_file = fopen("robust_trade_test.txt", "a");
-    // if (robust_trade_file == NULL) {
-    //     perror("[Fail] Unable to open robust_trade_test.txt.");
-    //     exit(1);
-    // }
-    // fprintf(robust_trade_file, "=== Robust Trade Test End ===\n");
-    // fclose(robust_trade_file);
-
     // printf("=== All Tests Completed ===\n");
 
+    // per-stage spans, only recorded when built with ECR_TRACE
+    TraceDump("trace_output");
+
+    // every test above shared the pairings parsed on first use
+    PairingRegistryClear();
+
     return 0;
 }
\ No newline at end of file
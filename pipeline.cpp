@@ -0,0 +1,190 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: ziyidong.cs@gmail.com
+ */
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pbc.h"
+#include "wots.h"
+#include "xmss.h"
+#include "ccastruct.h"
+#include "cpastruct.h"
+#include "ccaenc.h"
+#include "ccamap.h"
+#include "scratch.h"
+#include "pipeline.h"
+
+
+// Bounded multi-producer multi-consumer ring of trade indices. Each cell's sequence
+// number says whose turn it is, so producers and consumers only race on head/tail.
+class PipelineQueue
+{
+public:
+    PipelineQueue() : head(0), tail(0)
+    {
+        for (size_t i = 0; i < PIPELINE_QUEUE_DEPTH; i++)
+        {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool TryPush(int value)
+    {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells[pos % PIPELINE_QUEUE_DEPTH];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            long diff = (long)seq - (long)pos;
+            if (diff == 0)
+            {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.value = value;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;       // full
+            }
+            else
+            {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool TryPop(int &value)
+    {
+        size_t pos = head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells[pos % PIPELINE_QUEUE_DEPTH];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            long diff = (long)seq - (long)(pos + 1);
+            if (diff == 0)
+            {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    value = cell.value;
+                    cell.seq.store(pos + PIPELINE_QUEUE_DEPTH, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;       // empty
+            }
+            else
+            {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void Push(int value)
+    {
+        while (!TryPush(value))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    int Pop()
+    {
+        int value;
+        while (!TryPop(value))
+        {
+            std::this_thread::yield();
+        }
+        return value;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        int value;
+    };
+    Cell cells[PIPELINE_QUEUE_DEPTH];
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+};
+
+
+// Every trade passes each stage exactly once, so a stage's workers stop after
+// claiming trade_number items between them
+void ccaSenderPipeline(pairing_t pairing, pkg_params &pkg_params, ts_params &ts_params, element_t user_Alice_Pub, UserPrivateKey &User_Alice_Priv, element_t Time_Pub, element_t vk,
+                       element_t PT[], int trade_number, XmssKey &key,
+                       ccaCiphertext PCT[], uint8_t message[][WOTS_N], XmssSignature sig[],
+                       int enc_threads, int hash_threads, int sign_threads)
+{
+    if (trade_number <= 0)
+    {
+        return;
+    }
+    PipelineQueue encrypted, digested;
+    std::atomic<int> enc_claimed(0), hash_claimed(0), sign_claimed(0);
+    // the tree state advances one leaf per signature, signers take turns on it
+    std::mutex key_lock;
+
+    auto enc_stage = [&]() {
+        int i;
+        while ((i = enc_claimed.fetch_add(1)) < trade_number)
+        {
+            ccaEnc(pairing, pkg_params, ts_params, user_Alice_Pub, User_Alice_Priv, Time_Pub, vk, PT[i], PCT[i]);
+            encrypted.Push(i);
+        }
+        ScratchArenaRelease();
+    };
+    auto hash_stage = [&]() {
+        while (hash_claimed.fetch_add(1) < trade_number)
+        {
+            int i = encrypted.Pop();
+            ccaCiphertextDigest(PCT[i], message[i]);
+            digested.Push(i);
+        }
+    };
+    auto sign_stage = [&]() {
+        while (sign_claimed.fetch_add(1) < trade_number)
+        {
+            int i = digested.Pop();
+            std::lock_guard<std::mutex> guard(key_lock);
+            if (!xmss_sign(key, sig[i], message[i]))
+            {
+                printf("[FAIL] XMSS key has no leaves left.\n");
+                exit(1);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < (enc_threads > 0 ? enc_threads : 1); t++)
+    {
+        pool.emplace_back(enc_stage);
+    }
+    for (int t = 0; t < (hash_threads > 0 ? hash_threads : 1); t++)
+    {
+        pool.emplace_back(hash_stage);
+    }
+    for (int t = 0; t < (sign_threads > 0 ? sign_threads : 1); t++)
+    {
+        pool.emplace_back(sign_stage);
+    }
+    for (auto &t : pool)
+    {
+        t.join();
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: ziyidong.cs@gmail.com
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pbc.h"
+#include "cpastruct.h"
+#include "precompute.h"
+#include "scratch.h"
+
+
+// g2 = g when G1 and G2 coincide, so the symmetric scheme is unchanged
+void ParamsG2Generator(pairing_t pairing, element_t g, element_t g2)
+{
+    if (pairing_is_symmetric(pairing))
+    {
+        element_set(g2, g);
+    }
+    else
+    {
+        element_random(g2);
+    }
+}
+
+// PKG fixed-base tables, G1, G2 and GT
+void PkgParamsPrecompute(pkg_params &pkg_params)
+{
+    element_pp_init(pkg_params.g_pp, pkg_params.g);
+    element_pp_init(pkg_params.g1_pp, pkg_params.g1);
+    element_pp_init(pkg_params.g2_pp, pkg_params.g2);
+
+    element_init_same_as(pkg_params.e_g_h_inv, pkg_params.e_g_h);
+    element_invert(pkg_params.e_g_h_inv, pkg_params.e_g_h);
+    element_pp_init(pkg_params.e_g_g_pp, pkg_params.e_g_g);
+    element_pp_init(pkg_params.e_g_h_inv_pp, pkg_params.e_g_h_inv);
+}
+
+// TS fixed-base tables, G1, G2 and GT
+void TsParamsPrecompute(ts_params &ts_params)
+{
+    element_pp_init(ts_params.g_pp, ts_params.g);
+    element_pp_init(ts_params.g1_pp, ts_params.g1);
+    element_pp_init(ts_params.g2_pp, ts_params.g2);
+
+    element_init_same_as(ts_params.e_g_h_inv, ts_params.e_g_h);
+    element_invert(ts_params.e_g_h_inv, ts_params.e_g_h);
+    element_pp_init(ts_params.e_g_g_pp, ts_params.e_g_g);
+    element_pp_init(ts_params.e_g_h_inv_pp, ts_params.e_g_h_inv);
+}
+
+void PkgParamsPrecomputeClear(pkg_params &pkg_params)
+{
+    element_pp_clear(pkg_params.g_pp);
+    element_pp_clear(pkg_params.g1_pp);
+    element_pp_clear(pkg_params.g2_pp);
+    element_pp_clear(pkg_params.e_g_g_pp);
+    element_pp_clear(pkg_params.e_g_h_inv_pp);
+    element_clear(pkg_params.e_g_h_inv);
+}
+
+void TsParamsPrecomputeClear(ts_params &ts_params)
+{
+    element_pp_clear(ts_params.g_pp);
+    element_pp_clear(ts_params.g1_pp);
+    element_pp_clear(ts_params.g2_pp);
+    element_pp_clear(ts_params.e_g_g_pp);
+    element_pp_clear(ts_params.e_g_h_inv_pp);
+    element_clear(ts_params.e_g_h_inv);
+}
+
+
+
+// The scheme pairs ciphertext components against K, e(C, K) = e(K, C) on the symmetric pairing.
+// pairing_pp_t only preprocesses a G1 argument, K is in G2 on an asymmetric pairing.
+void PrepareUserPrivateKey(pairing_t pairing, UserPrivateKey &privatekey, PreparedUserPrivateKey &prepared)
+{
+    if (!pairing_is_symmetric(pairing))
+    {
+        printf("[FAIL] Prepared keys need a symmetric pairing.\n");
+        exit(1);
+    }
+    prepared.r = privatekey.r;
+    pairing_pp_init(prepared.K, privatekey.K, pairing);
+}
+
+void PrepareTimeTrapDoor(pairing_t pairing, TimeTrapDoor &Time_St, PreparedTimeTrapDoor &prepared)
+{
+    if (!pairing_is_symmetric(pairing))
+    {
+        printf("[FAIL] Prepared keys need a symmetric pairing.\n");
+        exit(1);
+    }
+    prepared.r = Time_St.r;
+    pairing_pp_init(prepared.K, Time_St.K, pairing);
+}
+
+void PreparedUserPrivateKeyClear(PreparedUserPrivateKey &prepared)
+{
+    pairing_pp_clear(prepared.K);
+    prepared.r = NULL;
+}
+
+void PreparedTimeTrapDoorClear(PreparedTimeTrapDoor &prepared)
+{
+    pairing_pp_clear(prepared.K);
+    prepared.r = NULL;
+}
+
+
+// element_prod_pairing shares the final exponentiation, but PBC only ships an
+// affine product for Type A, which loses to two projective pairings there
+// (see bendmarking_prod_pairing). The fused path is used on asymmetric pairings.
+void PairingProd2(element_t out, element_t a1, element_t b1, element_t a2, element_t b2, pairing_t pairing)
+{
+    if (pairing_is_symmetric(pairing))
+    {
+        ScratchFrame frame(pairing);
+        element_ptr temp = frame.GT();
+        pairing_apply(out, a1, b1, pairing);
+        pairing_apply(temp, a2, b2, pairing);
+        element_mul(out, out, temp);
+        return;
+    }
+
+    // element_prod_pairing only reads its inputs, shallow copies avoid re-initialising them
+    element_t in1[2], in2[2];
+    in1[0][0] = *a1;
+    in1[1][0] = *a2;
+    in2[0][0] = *b1;
+    in2[1][0] = *b2;
+
+    element_prod_pairing(out, in1, in2, 2);
+}
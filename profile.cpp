@@ -0,0 +1,307 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: ziyidong.cs@gmail.com
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pbc.h"
+#include "registry.h"
+#include "cpastruct.h"
+#include "ccastruct.h"
+#include "ccakeygen.h"
+#include "ccaenc.h"
+#include "ccadec.h"
+#include "ccamap.h"
+#include "codec.h"
+#include "precompute.h"
+#include "profile.h"
+#include "bench.h"
+
+// i.param is left out: PBC leaves its GT (GF(3^m)) without a byte encoding, which the
+// codec, ccaCiphertextDigest and HybridKey need
+const char *const CURVE_PARAM_FILES[] = {
+    "../param/a.param",
+    "../param/a1.param",
+    "../param/a_r160_q512.param",
+    "../param/d105171-196-185.param",
+    "../param/d159.param",
+    "../param/d201.param",
+    "../param/d224.param",
+    "../param/d277699-175-167.param",
+    "../param/d278027-190-181.param",
+    "../param/e.param",
+    "../param/f.param",
+    "../param/g149.param",
+};
+const int CURVE_PARAM_COUNT = sizeof(CURVE_PARAM_FILES) / sizeof(CURVE_PARAM_FILES[0]);
+
+// Curve points are sent compressed by the codec, see codec.h
+static int profile_point_bytes(element_t e)
+{
+    return element_length_in_bytes_compressed(e);
+}
+
+// Element sizes and primitive costs. The pairing takes its first argument from G1
+// and its second from G2, on symmetric pairings both are the same group.
+static void profile_primitives(pairing_ptr pairing, const char *param_file, BenchReport &report)
+{
+    element_t P, Q, R, S, a, T, U;
+    element_init_G1(P, pairing);
+    element_init_G2(Q, pairing);
+    element_init_G1(R, pairing);
+    element_init_G2(S, pairing);
+    element_init_Zr(a, pairing);
+    element_init_GT(T, pairing);
+    element_init_GT(U, pairing);
+    element_random(P);
+    element_random(Q);
+    element_random(a);
+    pairing_apply(U, P, Q, pairing);
+
+    BenchRun(report, BENCH_PAIRING, param_file, [&]() { pairing_apply(T, P, Q, pairing); });
+    BenchRun(report, BENCH_POW_G1, param_file, [&]() { element_pow_zn(R, P, a); });
+    BenchRun(report, BENCH_POW_G2, param_file, [&]() { element_pow_zn(S, Q, a); });
+    BenchRun(report, BENCH_POW_GT, param_file, [&]() { element_pow_zn(T, U, a); });
+
+    printf("%s %s, r: %d bits\n", param_file, pairing_is_symmetric(pairing) ? "symmetric" : "asymmetric",
+           (int)mpz_sizeinbase(pairing->r, 2));
+    BenchRecordValue(report, BENCH_G1_BYTES, param_file, profile_point_bytes(P));
+    BenchRecordValue(report, BENCH_G2_BYTES, param_file, profile_point_bytes(Q));
+    BenchRecordValue(report, BENCH_GT_BYTES, param_file, element_length_in_bytes(T));
+
+    element_clear(P);
+    element_clear(Q);
+    element_clear(R);
+    element_clear(S);
+    element_clear(a);
+    element_clear(T);
+    element_clear(U);
+}
+
+// Full keygen/Enc/ReEnc/Dec round, the setup of ccamain. Returns 1 if Bob (through the
+// codec) and Alice both recover PT.
+static int profile_scheme(pairing_ptr pairing, const char *param_file, BenchReport &report)
+{
+    element_t ts_priv, pkg_priv, vk, k3, user_Alice_Pub, user_Bob_Pub, Time_Pub;
+    element_init_Zr(ts_priv, pairing);
+    element_init_Zr(pkg_priv, pairing);
+    element_init_Zr(vk, pairing);
+    element_init_Zr(k3, pairing);
+    element_init_Zr(user_Alice_Pub, pairing);
+    element_init_Zr(user_Bob_Pub, pairing);
+    element_init_Zr(Time_Pub, pairing);
+    element_random(ts_priv);
+    element_random(pkg_priv);
+    element_random(vk);
+    element_random(k3);
+    element_random(user_Bob_Pub);
+
+    char Alice[] = "sender.alice@gmail.com";
+    char Time[] = "2025-5-5 12:00:00";
+    ccaid_to_zr(pairing, Alice, user_Alice_Pub);
+    ccaid_to_zr(pairing, Time, Time_Pub);
+
+    pkg_params pkg_params;
+    ts_params ts_params;
+
+    element_init_G1(ts_params.g, pairing);
+    element_init_G2(ts_params.g2, pairing);
+    element_init_G2(ts_params.h, pairing);
+    element_init_G1(ts_params.g1, pairing);
+    element_init_GT(ts_params.e_g_g, pairing);
+    element_init_GT(ts_params.e_g_h, pairing);
+    element_random(ts_params.g);
+    ParamsG2Generator(pairing, ts_params.g, ts_params.g2);
+    element_random(ts_params.h);
+    element_pow_zn(ts_params.g1, ts_params.g, ts_priv);
+    pairing_apply(ts_params.e_g_g, ts_params.g, ts_params.g2, pairing);
+    pairing_apply(ts_params.e_g_h, ts_params.g, ts_params.h, pairing);
+    TsParamsPrecompute(ts_params);
+
+    element_init_G1(pkg_params.g, pairing);
+    element_init_G2(pkg_params.g2, pairing);
+    element_init_G2(pkg_params.h, pairing);
+    element_init_G1(pkg_params.g1, pairing);
+    element_init_GT(pkg_params.e_g_g, pairing);
+    element_init_GT(pkg_params.e_g_h, pairing);
+    element_random(pkg_params.g);
+    ParamsG2Generator(pairing, pkg_params.g, pkg_params.g2);
+    element_random(pkg_params.h);
+    element_pow_zn(pkg_params.g1, pkg_params.g, pkg_priv);
+    pairing_apply(pkg_params.e_g_g, pkg_params.g, pkg_params.g2, pairing);
+    pairing_apply(pkg_params.e_g_h, pkg_params.g, pkg_params.h, pairing);
+    PkgParamsPrecompute(pkg_params);
+
+    UserPrivateKey User_Alice_Priv, User_Bob_Priv;
+    TimeTrapDoor Time_St;
+    element_init_Zr(User_Alice_Priv.r, pairing);
+    element_init_G2(User_Alice_Priv.K, pairing);
+    element_init_Zr(User_Bob_Priv.r, pairing);
+    element_init_G2(User_Bob_Priv.K, pairing);
+    element_init_Zr(Time_St.r, pairing);
+    element_init_G2(Time_St.K, pairing);
+
+    element_t PT, PT_Alice, PT_Bob, rk, PX, X;
+    element_init_GT(PT, pairing);
+    element_init_GT(PT_Alice, pairing);
+    element_init_GT(PT_Bob, pairing);
+    element_init_G2(rk, pairing);
+    element_init_GT(PX, pairing);
+    element_init_GT(X, pairing);
+    element_random(PT);
+
+    ccaCiphertext PCT;
+    element_init_G1(PCT.C1, pairing);
+    element_init_GT(PCT.C2, pairing);
+    element_init_G1(PCT.C3, pairing);
+    element_init_GT(PCT.C4, pairing);
+    element_init_GT(PCT.C5, pairing);
+    element_init_G2(PCT.C6, pairing);
+
+    ccaReCiphertext RCT;
+    element_init_G1(RCT.C1, pairing);
+    element_init_GT(RCT.C2, pairing);
+    element_init_G1(RCT.C3, pairing);
+    element_init_GT(RCT.C4, pairing);
+    element_init_GT(RCT.C5, pairing);
+    element_init_G2(RCT.C6, pairing);
+    element_init_G2(RCT.RK2, pairing);
+    element_init_GT(RCT.C32, pairing);
+
+    ccaReDelta Delta;
+    element_init_G2(Delta.RK2, pairing);
+    element_init_GT(Delta.C32, pairing);
+
+    ccaRj rj_bob;
+    element_init_G1(rj_bob.u, pairing);
+    element_init_GT(rj_bob.v, pairing);
+    element_init_GT(rj_bob.w, pairing);
+
+    ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, user_Bob_Pub, User_Bob_Priv);
+    BenchRun(report, BENCH_CCA_KEYGEN, param_file, [&]() { ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, user_Alice_Pub, User_Alice_Priv); });
+    BenchRun(report, BENCH_CCA_TRAPDOOR, param_file, [&]() { ccaTimeTrapDoorGen(pairing, ts_priv, ts_params, Time_Pub, Time_St); });
+    BenchRun(report, BENCH_CCA_ENC, param_file, [&]() { ccaEnc(pairing, pkg_params, ts_params, user_Alice_Pub, User_Alice_Priv, Time_Pub, vk, PT, PCT); });
+    BenchRun(report, BENCH_CCA_RKGEN, param_file, [&]() { ccaRkGen(pairing, User_Alice_Priv, PCT, rk, PX); });
+    BenchRun(report, BENCH_CCA_RJGEN, param_file, [&]() { ccaRjGen(pairing, pkg_params, user_Bob_Pub, PX, k3, rj_bob); });
+    BenchRun(report, BENCH_CCA_REENC, param_file, [&]() { ccaReEnc(pairing, PCT, rk, pkg_params, vk, RCT); });
+    ccaReEncDelta(pairing, PCT, rk, pkg_params, vk, Delta);
+
+    // Bob decrypts RCT as it comes off the wire
+    unsigned char wire[4096];
+    size_t wire_len = ccaReCiphertextEncode(pairing, RCT, wire, sizeof(wire));
+    int success = wire_len && ccaReCiphertextDecode(pairing, wire, wire_len, RCT);
+
+    BenchRun(report, BENCH_CCA_DEC1, param_file, [&]() { ccaDec1(pairing, User_Bob_Priv, rj_bob, X); });
+    BenchRun(report, BENCH_CCA_DEC2, param_file, [&]() { ccaDec2(pairing, User_Bob_Priv, RCT, Time_St, rj_bob, X, PT_Bob); });
+    BenchRun(report, BENCH_CCA_SENDER_DEC, param_file, [&]() { ccaSenderDec(pairing, pkg_params, ts_params, User_Alice_Priv, Time_St, PCT, PT_Alice); });
+
+    success = success && !element_cmp(PT_Bob, PT) && !element_cmp(PT_Alice, PT);
+
+    BenchRecordValue(report, BENCH_CIPHERTEXT_BYTES, param_file, ccaCiphertextEncodedLength(pairing, PCT));
+    BenchRecordValue(report, BENCH_RECIPHERTEXT_BYTES, param_file, ccaReCiphertextEncodedLength(pairing, RCT));
+    BenchRecordValue(report, BENCH_REDELTA_BYTES, param_file, ccaReDeltaEncodedLength(pairing, Delta));
+    BenchRecordValue(report, BENCH_RJ_BYTES, param_file, ccaRjEncodedLength(pairing, rj_bob));
+
+    // clear memory
+    element_clear(rj_bob.u);
+    element_clear(rj_bob.v);
+    element_clear(rj_bob.w);
+    element_clear(Delta.RK2);
+    element_clear(Delta.C32);
+    element_clear(RCT.C1);
+    element_clear(RCT.C2);
+    element_clear(RCT.C3);
+    element_clear(RCT.C4);
+    element_clear(RCT.C5);
+    element_clear(RCT.C6);
+    element_clear(RCT.RK2);
+    element_clear(RCT.C32);
+    element_clear(PCT.C1);
+    element_clear(PCT.C2);
+    element_clear(PCT.C3);
+    element_clear(PCT.C4);
+    element_clear(PCT.C5);
+    element_clear(PCT.C6);
+    element_clear(PT);
+    element_clear(PT_Alice);
+    element_clear(PT_Bob);
+    element_clear(rk);
+    element_clear(PX);
+    element_clear(X);
+    element_clear(User_Alice_Priv.r);
+    element_clear(User_Alice_Priv.K);
+    element_clear(User_Bob_Priv.r);
+    element_clear(User_Bob_Priv.K);
+    element_clear(Time_St.r);
+    element_clear(Time_St.K);
+
+    PkgParamsPrecomputeClear(pkg_params);
+    element_clear(pkg_params.g);
+    element_clear(pkg_params.g2);
+    element_clear(pkg_params.h);
+    element_clear(pkg_params.g1);
+    element_clear(pkg_params.e_g_g);
+    element_clear(pkg_params.e_g_h);
+    TsParamsPrecomputeClear(ts_params);
+    element_clear(ts_params.g);
+    element_clear(ts_params.g2);
+    element_clear(ts_params.h);
+    element_clear(ts_params.g1);
+    element_clear(ts_params.e_g_g);
+    element_clear(ts_params.e_g_h);
+
+    element_clear(ts_priv);
+    element_clear(pkg_priv);
+    element_clear(vk);
+    element_clear(k3);
+    element_clear(user_Alice_Pub);
+    element_clear(user_Bob_Pub);
+    element_clear(Time_Pub);
+
+    return success;
+}
+
+
+int curveProfile(const char *const param_files[], int count)
+{
+    if (!param_files)
+    {
+        param_files = CURVE_PARAM_FILES;
+        count = CURVE_PARAM_COUNT;
+    }
+
+    BenchReport report;
+    report.suite = "curve_profile";
+
+    int success = 1;
+    for (int i = 0; i < count; i++)
+    {
+        pairing_ptr pairing = PairingAcquire(param_files[i]);
+        if (!pairing)
+        {
+            printf("%s skipped: not a usable param file\n", param_files[i]);
+            continue;
+        }
+        printf("Profiling %s\n", param_files[i]);
+        profile_primitives(pairing, param_files[i], report);
+        if (!profile_scheme(pairing, param_files[i], report))
+        {
+            printf("[FAIL] Decryption failed on %s.\n", param_files[i]);
+            success = 0;
+        }
+    }
+
+    BenchPrint(report);
+    if (!BenchWrite(report, "curve_profile_output"))
+    {
+        exit(1);
+    }
+    return success;
+}
@@ -0,0 +1,95 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: ziyidong.cs@gmail.com
+ */
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "pbc.h"
+#include "scratch.h"
+#include "registry.h"
+
+
+// Pairings live in heap cells so their address stays put for the elements bound to them
+static std::mutex registry_lock;
+static std::map<std::string, pairing_ptr> registry;
+
+static char *registry_read(const char *param_file)
+{
+    FILE *fp = fopen(param_file, "r");
+    if (!fp)
+    {
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    rewind(fp);
+    char *param = size >= 0 ? (char *)malloc(size + 1) : NULL;
+    if (!param)
+    {
+        fclose(fp);
+        return NULL;
+    }
+    size_t count = fread(param, 1, size, fp);
+    fclose(fp);
+    param[count] = '\0';
+    return param;
+}
+
+pairing_ptr PairingAcquire(const char *param_file)
+{
+    char resolved[PATH_MAX];
+    std::string key = realpath(param_file, resolved) ? resolved : param_file;
+
+    // Whoever comes first pays for init, the rest wait for it instead of parsing again
+    std::lock_guard<std::mutex> guard(registry_lock);
+    auto found = registry.find(key);
+    if (found != registry.end())
+    {
+        return found->second;
+    }
+
+    char *param = registry_read(param_file);
+    if (!param)
+    {
+        printf("[FAIL] Param file open fail.\n");
+        return NULL;
+    }
+    pairing_ptr pairing = (pairing_ptr)malloc(sizeof(pairing_t));
+    if (!pairing)
+    {
+        perror("[FAIL] Memory allocation failed.");
+        exit(1);
+    }
+    int fail = pairing_init_set_str(pairing, param);
+    free(param);
+    if (fail)
+    {
+        printf("[FAIL] Parameters parse fail.\n");
+        free(pairing);
+        return NULL;
+    }
+    registry[key] = pairing;
+    return pairing;
+}
+
+void PairingRegistryClear()
+{
+    ScratchArenaRelease();
+    std::lock_guard<std::mutex> guard(registry_lock);
+    for (auto &entry : registry)
+    {
+        pairing_clear(entry.second);
+        free(entry.second);
+    }
+    registry.clear();
+}
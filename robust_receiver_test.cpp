@@ -16,14 +16,19 @@
 
 #include "sha.h"
 #include "pbc.h"
+#include "registry.h"
 #include "wots.h"
 #include "ccastruct.h"
 #include "ccaenc.h"
 #include "ccadec.h"
 #include "ccakeygen.h"
 #include "ccamap.h"
+#include "precompute.h"
+#include "scratch.h"
+#include "fanout.h"
 #include "sha.h"
 #include "robust_receiver_test.h"
+#include "bench.h"
 
 
 using namespace std;
@@ -32,38 +37,13 @@ using namespace std;
 int robustReceiverTest(int receiver_number)
 {
     int i;
-    FILE *file;
-    file = fopen("robust_receiver_test.txt", "a");
-    if (file == NULL) {
-        perror("[FAIL] Failed to open robust_receiver_test.txt");
-        exit(1);
-    }
     printf("=== Test Start, Receiver Number %d ===\n", receiver_number);
-    fprintf(file, "=== Test Start, Receiver Number %d ===\n", receiver_number);
-    fclose(file);
-
-
-    clock_t start_time, end_time;
-    
-    pairing_t pairing; 
 
-    FILE *fp = fopen("../param/a.param", "r");
-    if (!fp)
+    pairing_ptr pairing = PairingAcquire("../param/a.param");
+    if (!pairing)
     {
-        printf("[Fail] Param file open fail.\n");
         return 1;
     }
-
-
-    char param[1024];
-    size_t count = fread(param, 1, sizeof(param), fp);
-    fclose(fp); 
-    if (count == 0)
-    {
-        printf("[Fail] Parameters write fail.\n");
-    }
-    
-    pairing_init_set_str(pairing, param); 
     if (!pairing_is_symmetric(pairing))
     {
         printf("[Asymmetric] Pairing is an asymmetric pairing.\n");
@@ -76,8 +56,7 @@ int robustReceiverTest(int receiver_number)
     uint8_t sk_seed[WOTS_N] = {1};
     uint8_t message[WOTS_N] = {0x12};
 
-    uint8_t pk1[WOTS_LEN][WOTS_N];
-    uint8_t pk2[WOTS_LEN][WOTS_N];
+    uint8_t pk_root[WOTS_N];
     uint8_t sig[WOTS_LEN][WOTS_N];
   
     element_t ts_priv, pkg_priv;
@@ -115,43 +94,49 @@ int robustReceiverTest(int receiver_number)
     for (i = 0; i < receiver_number; i++)
     {
         element_init_Zr(receiver_privatekey[i].r, pairing);
-        element_init_G1(receiver_privatekey[i].K, pairing);
+        element_init_G2(receiver_privatekey[i].K, pairing);
     }
 
     pkg_params pkg_params; 
     ts_params ts_params; 
 
     element_init_G1(ts_params.g, pairing);
-    element_init_G1(ts_params.h, pairing);
+    element_init_G2(ts_params.g2, pairing);
+    element_init_G2(ts_params.h, pairing);
     element_init_G1(ts_params.g1, pairing);
     element_init_GT(ts_params.e_g_g, pairing);
     element_init_GT(ts_params.e_g_h, pairing);
     element_random(ts_params.g);
+    ParamsG2Generator(pairing, ts_params.g, ts_params.g2);
     element_random(ts_params.h);
     element_pow_zn(ts_params.g1, ts_params.g, ts_priv);
-    pairing_apply(ts_params.e_g_g, ts_params.g, ts_params.g, pairing);
+    pairing_apply(ts_params.e_g_g, ts_params.g, ts_params.g2, pairing);
     pairing_apply(ts_params.e_g_h, ts_params.g, ts_params.h, pairing);
+    TsParamsPrecompute(ts_params);
 
-    element_init_G1(pkg_params.g, pairing); 
-    element_init_G1(pkg_params.h, pairing);
+    element_init_G1(pkg_params.g, pairing);
+    element_init_G2(pkg_params.g2, pairing);
+    element_init_G2(pkg_params.h, pairing);
     element_init_G1(pkg_params.g1, pairing);
     element_init_GT(pkg_params.e_g_g, pairing);
     element_init_GT(pkg_params.e_g_h, pairing);
     element_random(pkg_params.g);
+    ParamsG2Generator(pairing, pkg_params.g, pkg_params.g2);
     element_random(pkg_params.h);
     element_pow_zn(pkg_params.g1, pkg_params.g, pkg_priv);
-    pairing_apply(pkg_params.e_g_g, pkg_params.g, pkg_params.g, pairing);
+    pairing_apply(pkg_params.e_g_g, pkg_params.g, pkg_params.g2, pairing);
     pairing_apply(pkg_params.e_g_h, pkg_params.g, pkg_params.h, pairing);
+    PkgParamsPrecompute(pkg_params);
 
     UserPrivateKey User_Alice_Priv, User_Bob_Priv; 
     TimeTrapDoor Time_St;
 
     element_init_Zr(User_Alice_Priv.r, pairing);
-    element_init_G1(User_Alice_Priv.K, pairing);
+    element_init_G2(User_Alice_Priv.K, pairing);
     element_init_Zr(Time_St.r, pairing);
-    element_init_G1(Time_St.K, pairing);
+    element_init_G2(Time_St.K, pairing);
     element_init_Zr(User_Bob_Priv.r, pairing);
-    element_init_G1(User_Bob_Priv.K, pairing);
+    element_init_G2(User_Bob_Priv.K, pairing);
     
     element_t PT;
     element_init_GT(PT, pairing);
@@ -167,104 +152,47 @@ int robustReceiverTest(int receiver_number)
     element_init_G1(PCT.C3, pairing);
     element_init_GT(PCT.C4, pairing);
     element_init_GT(PCT.C5, pairing);
-    element_init_G1(PCT.C6, pairing);
+    element_init_G2(PCT.C6, pairing);
+
+    BenchReport report;
+    report.suite = "robust_receiver_test";
+    char context[32];
+    snprintf(context, sizeof(context), "receivers %d", receiver_number);
 
     // Time-consuming to generate the sender's private key
-    start_time = clock();
-    wots_keygen(pk1, sk_seed);
-    ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, user_Alice_Pub, User_Alice_Priv);
-    end_time = clock();
-    double sender_keygen_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("Time-consuming to generate the sender's private key: %.6f ms\n", sender_keygen_time);
-    file = fopen("robust_receiver_test.txt", "a"); 
-    fprintf(file, "Time-consuming to generate the sender's private key: %.6f ms\n", sender_keygen_time);
-    fclose(file);
-
-    // Receiver key generation time
-    start_time = clock();
-    for(i = 0; i < receiver_number; i++) {
-        ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, receiver_publickey[i], receiver_privatekey[i]);;
-    }
-    end_time = clock();
-    double receiver_keygen_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("Time-consuming to generate the receiver's private key: %.6f ms\n", receiver_keygen_time);
-    file = fopen("robust_receiver_test.txt", "a"); 
-    fprintf(file, "Time-consuming to generate the receiver's private key: %.6f ms\n", receiver_keygen_time);
-    fclose(file);
+    BenchRun(report, BENCH_SENDER_KEYGEN, context, [&]() {
+        wots_keygen_root(pk_root, sk_seed);
+        ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, user_Alice_Pub, User_Alice_Priv);
+    });
+
+    // Receiver key generation time, one pass over every receiver, the fan-out runs on all cores
+    BenchRunOnce(report, BENCH_RECEIVER_KEYGEN, context, [&]() {
+        ccaPrivatekeyGenParallel(pairing, pkg_priv, pkg_params, receiver_publickey, receiver_number, receiver_privatekey, 0);
+    }, receiver_number);
 
     ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, user_Bob_Pub, User_Bob_Priv);
  
     // Time trap gate generation time
-    start_time = clock();
-    ccaTimeTrapDoorGen(pairing, ts_priv, ts_params, Time_Pub, Time_St);
-    end_time = clock();
-    double time_trapdoor_gen_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("Time trap gate generation time: %.6f ms\n", time_trapdoor_gen_time);
-    file = fopen("robust_receiver_test.txt", "a");
-    fprintf(file, "Time trap gate generation time: %.6f ms\n", time_trapdoor_gen_time);
-    fclose(file);
+    BenchRun(report, BENCH_CCA_TRAPDOOR, context, [&]() {
+        ccaTimeTrapDoorGen(pairing, ts_priv, ts_params, Time_Pub, Time_St);
+    });
 
 
     // Sender encryption time
-    start_time = clock();
-    ccaEnc(pairing, pkg_params, ts_params, user_Alice_Pub, User_Alice_Priv, Time_Pub, vk, PT, PCT);
-    // Calculate the total byte length
-    element_t elements[6];
-    //Initialize elements to the corresponding groups
-    element_init_G1(elements[0], pairing);   
-    element_init_GT(elements[1], pairing);  
-    element_init_G1(elements[2], pairing);  
-    element_init_GT(elements[3], pairing); 
-    element_init_GT(elements[4], pairing); 
-    element_init_G1(elements[5], pairing);  
-
-    element_set(elements[0] ,PCT.C1);
-    element_set(elements[1] ,PCT.C2);
-    element_set(elements[2] ,PCT.C3);
-    element_set(elements[3] ,PCT.C4);
-    element_set(elements[4] ,PCT.C5);
-    element_set(elements[5] ,PCT.C6);
-
-    size_t total_len = 0;
-    for (int i = 0; i < 6; i++) {
-        total_len += element_length_in_bytes(elements[i]);
-    }
-    // Allocating Buffers
-    unsigned char *buffer = (unsigned char *)malloc(total_len);
-    if (!buffer) {
-        perror("Memory allocation failed");
-        exit(1);
-    }
-    // Serialize all elements into a buffer
-    size_t offset = 0;
-    for (int i = 0; i < 6; i++) {
-        int len = element_to_bytes(buffer + offset, elements[i]);
-        if (len != element_length_in_bytes(elements[i])) {
-            fprintf(stderr, "Serialization error: Element %d\n", i);
-            free(buffer);
-            exit(1);
-        }
-        offset += len;
-    }
-    SHA256(buffer, total_len, message); // hash to 256bit
-    wots_sign(sig, message, sk_seed);
-    end_time = clock();
-    double sender_enc_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("Sender encryption time: %.6f ms\n", sender_enc_time);
-    file = fopen("robust_receiver_test.txt", "a"); 
-    fprintf(file, "Sender encryption time: %.6f ms\n", sender_enc_time);
-    fclose(file);
-
-    // RK generation time
-    start_time = clock();
+    BenchRun(report, BENCH_SENDER_ENC, context, [&]() {
+        ccaEnc(pairing, pkg_params, ts_params, user_Alice_Pub, User_Alice_Priv, Time_Pub, vk, PT, PCT);
+        ccaCiphertextDigest(PCT, message); // hash to 256bit
+    });
+
+    // WOTS+ is one-time, every call signs the digest of the last PCT and gives the same signature
+    BenchRun(report, BENCH_WOTS_SIGN, context, [&]() {
+        wots_sign(sig, message, sk_seed);
+    });
+
     element_t rk, PX;
-    element_init_G1(rk, pairing);
+    element_init_G2(rk, pairing);
     element_init_GT(PX, pairing);
 
-    ccaRkGen(pairing, pkg_params, user_Alice_Pub, User_Alice_Priv, PCT, rk, PX);
-    element_printf("rk = %B\n", rk); 
-    element_printf("PX = %B\n", PX);  
-
     element_t k3;
     element_init_Zr(k3, pairing);
     element_random(k3);
@@ -274,17 +202,23 @@ int robustReceiverTest(int receiver_number)
     element_init_GT(rj_bob.v, pairing);
     element_init_GT(rj_bob.w, pairing);
 
+    ccaRj receiver_rj[receiver_number];
     for (i = 0; i < receiver_number; i++)
     {
-        ccaRjGen(pairing, pkg_params, User_Alice_Priv, receiver_publickey[i], rk, PX, k3, rj_bob);
+        element_init_G1(receiver_rj[i].u, pairing);
+        element_init_GT(receiver_rj[i].v, pairing);
+        element_init_GT(receiver_rj[i].w, pairing);
     }
 
-    end_time = clock();
-    double rk_gen_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("RK generation time: %.6f ms\n", rk_gen_time);
-    file = fopen("robust_receiver_test.txt", "a");
-    fprintf(file, "RK generation time: %.6f ms\n", rk_gen_time);
-    fclose(file);
+    // RK generation time, one pass over every receiver, the Rj fan-out runs on all cores
+    BenchRunOnce(report, BENCH_RK_RJ_GEN, context, [&]() {
+        ccaRkGen(pairing, User_Alice_Priv, PCT, rk, PX);
+        ccaRjGenParallel(pairing, pkg_params, receiver_publickey, receiver_number, PX, k3, receiver_rj, 0);
+    }, receiver_number);
+    element_printf("rk = %B\n", rk); 
+    element_printf("PX = %B\n", PX);  
+
+    ccaRjGen(pairing, pkg_params, user_Bob_Pub, PX, k3, rj_bob);
 
     ccaReCiphertext RCT;
     element_init_G1(RCT.C1, pairing);
@@ -292,78 +226,52 @@ int robustReceiverTest(int receiver_number)
     element_init_G1(RCT.C3, pairing);
     element_init_GT(RCT.C4, pairing);
     element_init_GT(RCT.C5, pairing);
-    element_init_G1(RCT.C6, pairing);
-    element_init_G1(RCT.RK2, pairing);
+    element_init_G2(RCT.C6, pairing);
+    element_init_G2(RCT.RK2, pairing);
     element_init_GT(RCT.C32, pairing);
 
     // ReEnc time
-    start_time = clock();
-    wots_pk_from_sig(pk2, sig, message);
     int receiversuccess = 1;
-    for (int i = 0; i < WOTS_LEN; i++) {
-        if (memcmp(pk1[i], pk2[i], WOTS_N) != 0) {
-            receiversuccess = 0;
-            break;
-        }
-    }
+    BenchRun(report, BENCH_REENC_STAGE, context, [&]() {
+        receiversuccess &= wots_verify(sig, message, pk_root);
+        ccaReEnc(pairing, PCT, rk, pkg_params, vk, RCT);
+    });
     printf("WOTS+ verification %s\n", receiversuccess ? "passed" : "failed");
-    ccaReEnc(pairing, PCT, rk, pkg_params, vk, RCT);
-    end_time = clock();
-    double reenc_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("ReEnc time: %.6f ms\n", reenc_time);
-    file = fopen("robust_receiver_test.txt", "a");
-    fprintf(file, "ReEnc time: %.6f ms\n", reenc_time);
-    fclose(file);
 
 
     // Decryption time for the receiver
-    start_time = clock();
-    wots_pk_from_sig(pk2, sig, message);
     int sendersuccess = 1;
-    for (int i = 0; i < WOTS_LEN; i++) {
-        if (memcmp(pk1[i], pk2[i], WOTS_N) != 0) {
-            sendersuccess = 0;
-            break;
-        }
-    }
-    printf("WOTS+ verification %s\n", sendersuccess ? "passed" : "failed");
     element_t X;
     element_init_GT(X, pairing);
-    ccaDec1(pairing, User_Bob_Priv, rj_bob, X);
-    ccaDec2(pairing, User_Bob_Priv, RCT, Time_St , rj_bob, X, PT_Bob);
-    end_time = clock();
-    double receiver_dec_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000; 
-    printf("Decryption time for the receiver: %.6f ms\n", receiver_dec_time);
-    file = fopen("robust_receiver_test.txt", "a"); 
-    fprintf(file, "Decryption time for the receiver: %.6f ms\n", receiver_dec_time);
-    fclose(file);
+    BenchRun(report, BENCH_RECEIVER_DEC, context, [&]() {
+        sendersuccess &= wots_verify(sig, message, pk_root);
+        ccaDec1(pairing, User_Bob_Priv, rj_bob, X);
+        ccaDec2(pairing, User_Bob_Priv, RCT, Time_St , rj_bob, X, PT_Bob);
+    });
+    printf("WOTS+ verification %s\n", sendersuccess ? "passed" : "failed");
 
     // Decryption time for sender
-    start_time = clock();
-    wots_pk_from_sig(pk2, sig, message);
-    printf("\n");
-
     sendersuccess = 1;
-    for (int i = 0; i < WOTS_LEN; i++) {
-        if (memcmp(pk1[i], pk2[i], WOTS_N) != 0) {
-            sendersuccess = 0;
-            break;
-        }
-    }
+    BenchRun(report, BENCH_SENDER_DEC, context, [&]() {
+        sendersuccess &= wots_verify(sig, message, pk_root);
+        ccaSenderDec(pairing, pkg_params, ts_params, User_Alice_Priv, Time_St, PCT, PT_Alice);
+    });
     printf("WOTS+ verification %s\n", sendersuccess ? "passed" : "failed");
-    
-    ccaSenderDec(pairing, pkg_params, ts_params, User_Alice_Priv, Time_St, PCT, PT_Alice);
-    end_time = clock();
-    double sender_dec_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("Decryption time for sender: %.6f ms\n", sender_dec_time);
-    file = fopen("robust_receiver_test.txt", "a");
-    fprintf(file, "Decryption time for sender: %.6f ms\n\n", sender_dec_time);
-    fclose(file);
+
+    BenchPrint(report);
+    char path_prefix[64];
+    snprintf(path_prefix, sizeof(path_prefix), "robust_receiver_test_%d", receiver_number);
+    if (!BenchWrite(report, path_prefix))
+    {
+        exit(1);
+    }
 
 
     // clear memory
     element_clear(pkg_priv);
+    PkgParamsPrecomputeClear(pkg_params);
     element_clear(pkg_params.g);
+    element_clear(pkg_params.g2);
     element_clear(pkg_params.h);
     element_clear(pkg_params.g1);
     element_clear(pkg_params.e_g_g);
@@ -394,7 +302,9 @@ int robustReceiverTest(int receiver_number)
     element_clear(RCT.C32);
 
     element_clear(ts_priv);
+    TsParamsPrecomputeClear(ts_params);
     element_clear(ts_params.g);
+    element_clear(ts_params.g2);
     element_clear(ts_params.h);
     element_clear(ts_params.g1);
     element_clear(ts_params.e_g_g);
@@ -408,12 +318,18 @@ int robustReceiverTest(int receiver_number)
     element_clear(rj_bob.v);
     element_clear(rj_bob.w);
 
+    for (i = 0; i < receiver_number; i++)
+    {
+        element_clear(receiver_rj[i].u);
+        element_clear(receiver_rj[i].v);
+        element_clear(receiver_rj[i].w);
+    }
+
     element_clear(vk);
     element_clear(sk);
 
     element_clear(user_Bob_Pub);
 
-    pairing_clear(pairing);
 
     return 1;
 }
\ No newline at end of file
@@ -12,60 +12,74 @@
 #include <iostream>
 #include <string.h>
 #include <stdint.h>
+#include <stdlib.h>
 
 
 #include "sha.h"
 #include "pbc.h"
+#include "registry.h"
 #include "wots.h"
+#include "xmss.h"
 #include "ccastruct.h"
 #include "ccaenc.h"
 #include "ccadec.h"
 #include "ccakeygen.h"
 #include "ccamap.h"
+#include "precompute.h"
+#include "fanout.h"
+#include "scratch.h"
+#include "pipeline.h"
 #include "sha.h"
 #include "robust_receiver_test.h"
 #include "robust_trade_test.h"
+#include "bench.h"
 
 
 using namespace std;
 
-// main function
-int robustTradeTest(int trade_number, int receiver_number)
+// Allocation counting over the steady-state loop, every hook forwards to libc
+#define ALLOC_COUNT_RENUM 100
+
+static long alloc_count = 0;
+
+static void *count_malloc(size_t size)
 {
-    int i, j;
-    int sign_flan = 0;
-    FILE *file;
-    file = fopen("robust_trade_test.txt", "a");
-    if (file == NULL) {
-        perror("[FAIL] Failed to open robust_trade_test.txt");
-        exit(1);
-    }
-    printf("=== Test Start, Trade Number %d, Receiver Number %d ===\n", trade_number, receiver_number);
-    fprintf(file, "=== Test Start, Receiver Number %d,  Receiver Number %d ===\n", trade_number, receiver_number);
-    fclose(file);
+    alloc_count++;
+    return malloc(size);
+}
 
+static void *count_realloc(void *ptr, size_t size)
+{
+    alloc_count++;
+    return realloc(ptr, size);
+}
 
-    clock_t start_time, end_time;
-    
-    pairing_t pairing; 
+static void count_free(void *ptr)
+{
+    free(ptr);
+}
 
-    FILE *fp = fopen("../param/a.param", "r");
-    if (!fp)
-    {
-        printf("[Fail] Param file open fail.\n");
-        return 1;
-    }
+static void *count_mp_realloc(void *ptr, size_t, size_t new_size)
+{
+    return count_realloc(ptr, new_size);
+}
+
+static void count_mp_free(void *ptr, size_t)
+{
+    free(ptr);
+}
 
+// main function
+int robustTradeTest(int trade_number, int receiver_number)
+{
+    int i;
+    printf("=== Test Start, Trade Number %d, Receiver Number %d ===\n", trade_number, receiver_number);
 
-    char param[1024];
-    size_t count = fread(param, 1, sizeof(param), fp);
-    fclose(fp); 
-    if (count == 0)
+    pairing_ptr pairing = PairingAcquire("../param/a.param");
+    if (!pairing)
     {
-        printf("[Fail] Parameters write fail.\n");
+        return 1;
     }
-    
-    pairing_init_set_str(pairing, param); 
     if (!pairing_is_symmetric(pairing))
     {
         printf("[Asymmetric] Pairing is an asymmetric pairing.\n");
@@ -78,9 +92,14 @@ int robustTradeTest(int trade_number, int receiver_number)
     uint8_t sk_seed[WOTS_N] = {1};
     uint8_t message[WOTS_N] = {1};
 
-    uint8_t pk1[WOTS_LEN][WOTS_N];
-    uint8_t pk2[WOTS_LEN][WOTS_N];
-    uint8_t sig[WOTS_LEN][WOTS_N];
+    // one tree covers every trade, the smallest even height with 2^h >= trade_number
+    int xmss_height = XMSS_BDS_K;
+    while ((1 << xmss_height) < trade_number) {
+        xmss_height += 2;
+    }
+    XmssKey *xmss_key = new XmssKey;
+    XmssSignature sig;
+    uint8_t xmss_root[WOTS_N];
   
     element_t ts_priv, pkg_priv;
     element_init_Zr(ts_priv, pairing);
@@ -117,43 +136,49 @@ int robustTradeTest(int trade_number, int receiver_number)
     for (i = 0; i < receiver_number; i++)
     {
         element_init_Zr(receiver_privatekey[i].r, pairing);
-        element_init_G1(receiver_privatekey[i].K, pairing);
+        element_init_G2(receiver_privatekey[i].K, pairing);
     }
 
     pkg_params pkg_params; 
     ts_params ts_params; 
 
     element_init_G1(ts_params.g, pairing);
-    element_init_G1(ts_params.h, pairing);
+    element_init_G2(ts_params.g2, pairing);
+    element_init_G2(ts_params.h, pairing);
     element_init_G1(ts_params.g1, pairing);
     element_init_GT(ts_params.e_g_g, pairing);
     element_init_GT(ts_params.e_g_h, pairing);
     element_random(ts_params.g);
+    ParamsG2Generator(pairing, ts_params.g, ts_params.g2);
     element_random(ts_params.h);
     element_pow_zn(ts_params.g1, ts_params.g, ts_priv);
-    pairing_apply(ts_params.e_g_g, ts_params.g, ts_params.g, pairing);
+    pairing_apply(ts_params.e_g_g, ts_params.g, ts_params.g2, pairing);
     pairing_apply(ts_params.e_g_h, ts_params.g, ts_params.h, pairing);
+    TsParamsPrecompute(ts_params);
 
-    element_init_G1(pkg_params.g, pairing); 
-    element_init_G1(pkg_params.h, pairing);
+    element_init_G1(pkg_params.g, pairing);
+    element_init_G2(pkg_params.g2, pairing);
+    element_init_G2(pkg_params.h, pairing);
     element_init_G1(pkg_params.g1, pairing);
     element_init_GT(pkg_params.e_g_g, pairing);
     element_init_GT(pkg_params.e_g_h, pairing);
     element_random(pkg_params.g);
+    ParamsG2Generator(pairing, pkg_params.g, pkg_params.g2);
     element_random(pkg_params.h);
     element_pow_zn(pkg_params.g1, pkg_params.g, pkg_priv);
-    pairing_apply(pkg_params.e_g_g, pkg_params.g, pkg_params.g, pairing);
+    pairing_apply(pkg_params.e_g_g, pkg_params.g, pkg_params.g2, pairing);
     pairing_apply(pkg_params.e_g_h, pkg_params.g, pkg_params.h, pairing);
+    PkgParamsPrecompute(pkg_params);
 
     UserPrivateKey User_Alice_Priv, User_Bob_Priv; 
     TimeTrapDoor Time_St;
 
     element_init_Zr(User_Alice_Priv.r, pairing);
-    element_init_G1(User_Alice_Priv.K, pairing);
+    element_init_G2(User_Alice_Priv.K, pairing);
     element_init_Zr(Time_St.r, pairing);
-    element_init_G1(Time_St.K, pairing);
+    element_init_G2(Time_St.K, pairing);
     element_init_Zr(User_Bob_Priv.r, pairing);
-    element_init_G1(User_Bob_Priv.K, pairing);
+    element_init_G2(User_Bob_Priv.K, pairing);
     
     element_t PT;
     element_init_GT(PT, pairing);
@@ -169,114 +194,82 @@ int robustTradeTest(int trade_number, int receiver_number)
     element_init_G1(PCT.C3, pairing);
     element_init_GT(PCT.C4, pairing);
     element_init_GT(PCT.C5, pairing);
-    element_init_G1(PCT.C6, pairing);
+    element_init_G2(PCT.C6, pairing);
 
-    // Time-consuming to generate the sender's private key
-    start_time = clock();
-    ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, user_Alice_Pub, User_Alice_Priv);
-    for (i = 0; i < trade_number; i++) {
-        wots_keygen(pk1, sk_seed);  // ??
-    }
-    end_time = clock();
-    double sender_keygen_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("Time-consuming to generate the sender's private key: %.6f ms\n", sender_keygen_time);
-    file = fopen("robust_trade_test.txt", "a"); 
-    fprintf(file, "Time-consuming to generate the sender's private key: %.6f ms\n", sender_keygen_time);
-    fclose(file);
+    BenchReport report;
+    report.suite = "robust_trade_test";
+    char context[48];
+    snprintf(context, sizeof(context), "trades %d receivers %d", trade_number, receiver_number);
 
+    // Time-consuming to generate the sender's private key, the XMSS tree is built once
+    BenchRunOnce(report, BENCH_SENDER_KEYGEN, context, [&]() {
+        ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, user_Alice_Pub, User_Alice_Priv);
+        xmss_keygen(*xmss_key, sk_seed, xmss_height);
+    });
+    memcpy(xmss_root, xmss_key->root, WOTS_N);  // published once, receivers verify against it
 
 
-    // Receiver key generation time
-    start_time = clock();
-    for(i = 0; i < receiver_number; i++) {
-        ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, receiver_publickey[i], receiver_privatekey[i]);
-    }
-    end_time = clock();
-    double receiver_keygen_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("Time-consuming to generate the receiver's private key: %.6f ms\n", receiver_keygen_time);
-    file = fopen("robust_trade_test.txt", "a"); 
-    fprintf(file, "Time-consuming to generate the receiver's private key: %.6f ms\n", receiver_keygen_time);
-    fclose(file);
+
+    // Receiver key generation time, one pass over every receiver, the fan-out runs on all cores
+    BenchRunOnce(report, BENCH_RECEIVER_KEYGEN, context, [&]() {
+        ccaPrivatekeyGenParallel(pairing, pkg_priv, pkg_params, receiver_publickey, receiver_number, receiver_privatekey, 0);
+    }, receiver_number);
 
     ccaPrivatekeyGen(pairing, pkg_priv, pkg_params, user_Bob_Pub, User_Bob_Priv);
  
 
-    // Time trap gate generation time
-    start_time = clock();
-    for(i = 0; i < trade_number; i++) {
+    // Time trap gate generation time, per trade
+    BenchRun(report, BENCH_CCA_TRAPDOOR, context, [&]() {
         ccaTimeTrapDoorGen(pairing, ts_priv, ts_params, Time_Pub, Time_St);
-    }
-    end_time = clock();
-    double time_trapdoor_gen_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("Time trap gate generation time: %.6f ms\n", time_trapdoor_gen_time);
-    file = fopen("robust_trade_test.txt", "a");
-    fprintf(file, "Time trap gate generation time: %.6f ms\n", time_trapdoor_gen_time);
-    fclose(file);
+    });
 
 
-    // Sender encryption time
-    start_time = clock();
-    for(i = 0; i < trade_number; i++) {
-        ccaEnc(pairing, pkg_params, ts_params, user_Alice_Pub, User_Alice_Priv, Time_Pub, vk, PT, PCT);
-        // Calculate the total byte length
-        element_t elements[6];
-        //Initialize elements to the corresponding groups
-        element_init_G1(elements[0], pairing);   
-        element_init_GT(elements[1], pairing);  
-        element_init_G1(elements[2], pairing);  
-        element_init_GT(elements[3], pairing); 
-        element_init_GT(elements[4], pairing); 
-        element_init_G1(elements[5], pairing);  
-
-        element_set(elements[0] ,PCT.C1);
-        element_set(elements[1] ,PCT.C2);
-        element_set(elements[2] ,PCT.C3);
-        element_set(elements[3] ,PCT.C4);
-        element_set(elements[4] ,PCT.C5);
-        element_set(elements[5] ,PCT.C6);
-        size_t total_len = 0;
-        for (j = 0; j < 6; j++) {
-            total_len += element_length_in_bytes(elements[j]);
-        }
-        // Allocating Buffers
-        unsigned char *buffer = (unsigned char *)malloc(total_len);
-        if (!buffer) {
-            perror("Memory allocation failed");
-            exit(1);
-        }
-        // Serialize all elements into a buffer
-        size_t offset = 0;
-        for (j = 0; j < 6; j++) {
-            int len = element_to_bytes(buffer + offset, elements[j]);
-            if (len != element_length_in_bytes(elements[j])) {
-                fprintf(stderr, "Serialization error: Element %d\n", j);
-                free(buffer);
-                exit(1);
-            }
-            offset += len;
-        }
-        SHA256(buffer, total_len, message); // hash to 256bit
-        wots_sign(sig, message, sk_seed);
-        free(buffer);
-
-        element_clear(elements[0]);
-        element_clear(elements[1]);
-        element_clear(elements[2]);
-        element_clear(elements[3]);
-        element_clear(elements[4]);
-        element_clear(elements[5]);
+    // Sender encryption time per trade, encrypt / digest / sign pipelined. Signing
+    // advances the XMSS key, so the pipeline runs once.
+    ccaCiphertext trade_PCT[trade_number];
+    element_t trade_PT[trade_number];
+    uint8_t (*trade_message)[WOTS_N] = new uint8_t[trade_number][WOTS_N];
+    XmssSignature *trade_sig = new XmssSignature[trade_number];
+    for (i = 0; i < trade_number; i++) {
+        element_init_G1(trade_PCT[i].C1, pairing);
+        element_init_GT(trade_PCT[i].C2, pairing);
+        element_init_G1(trade_PCT[i].C3, pairing);
+        element_init_GT(trade_PCT[i].C4, pairing);
+        element_init_GT(trade_PCT[i].C5, pairing);
+        element_init_G2(trade_PCT[i].C6, pairing);
+        element_init_GT(trade_PT[i], pairing);
+        element_set(trade_PT[i], PT);
     }
-    end_time = clock();
-    double sender_enc_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("Sender encryption time: %.6f ms\n", sender_enc_time);
-    file = fopen("robust_trade_test.txt", "a"); 
-    fprintf(file, "Sender encryption time: %.6f ms\n", sender_enc_time);
-    fclose(file);
+    BenchRunOnce(report, BENCH_SENDER_ENC, context, [&]() {
+        ccaSenderPipeline(pairing, pkg_params, ts_params, user_Alice_Pub, User_Alice_Priv, Time_Pub, vk, trade_PT, trade_number, *xmss_key,
+                          trade_PCT, trade_message, trade_sig, FanoutThreads(0), 1, 1);
+    }, trade_number);
+
+    // the rest of the test follows the last trade
+    element_set(PCT.C1, trade_PCT[trade_number - 1].C1);
+    element_set(PCT.C2, trade_PCT[trade_number - 1].C2);
+    element_set(PCT.C3, trade_PCT[trade_number - 1].C3);
+    element_set(PCT.C4, trade_PCT[trade_number - 1].C4);
+    element_set(PCT.C5, trade_PCT[trade_number - 1].C5);
+    element_set(PCT.C6, trade_PCT[trade_number - 1].C6);
+    memcpy(message, trade_message[trade_number - 1], WOTS_N);
+    sig = trade_sig[trade_number - 1];
+    for (i = 0; i < trade_number; i++) {
+        element_clear(trade_PCT[i].C1);
+        element_clear(trade_PCT[i].C2);
+        element_clear(trade_PCT[i].C3);
+        element_clear(trade_PCT[i].C4);
+        element_clear(trade_PCT[i].C5);
+        element_clear(trade_PCT[i].C6);
+        element_clear(trade_PT[i]);
+    }
+    delete[] trade_message;
+    delete[] trade_sig;
 
 
     element_t rk[trade_number];
     for (i = 0; i < trade_number; i++) {
-        element_init_G1(rk[i], pairing);
+        element_init_G2(rk[i], pairing);
     }
     element_t PX[trade_number];
     for (i = 0; i < trade_number; i++) {
@@ -292,29 +285,25 @@ int robustTradeTest(int trade_number, int receiver_number)
         element_init_GT(rj_bob[i].v, pairing);
         element_init_GT(rj_bob[i].w, pairing);
     }
+    ccaRj receiver_rj[receiver_number];
+    for (i = 0; i < receiver_number; i++) {
+        element_init_G1(receiver_rj[i].u, pairing);
+        element_init_GT(receiver_rj[i].v, pairing);
+        element_init_GT(receiver_rj[i].w, pairing);
+    }
 
-    // RK Rj generation time
-    start_time = clock();
-    for(i = 0; i < 1; i++) {
-
-        ccaRkGen(pairing, pkg_params, user_Alice_Pub, User_Alice_Priv, PCT, rk[i], PX[i]);
-
-        element_t k3;
-        element_init_Zr(k3, pairing);
-        element_random(k3);
-
-        for (j = 0; j < receiver_number; j++)
-        {
-            ccaRjGen(pairing, pkg_params, User_Alice_Priv, receiver_publickey[i], rk[i], PX[i], k3, rj_bob[i]);
-        }
+    element_t k3;
+    element_init_Zr(k3, pairing);
+    element_random(k3);
 
-    }
-    end_time = clock();
-    double rk_gen_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("RK generation time: %.6f ms\n", rk_gen_time);
-    file = fopen("robust_trade_test.txt", "a");
-    fprintf(file, "RK generation time: %.6f ms\n", rk_gen_time);
-    fclose(file);
+    // RK Rj generation time, one pass over every receiver, the Rj fan-out runs on all cores
+    BenchRunOnce(report, BENCH_RK_RJ_GEN, context, [&]() {
+        ccaRkGen(pairing, User_Alice_Priv, PCT, rk[0], PX[0]);
+        ccaRjGenParallel(pairing, pkg_params, receiver_publickey, receiver_number, PX[0], k3, receiver_rj, 0);
+    }, receiver_number);
+    element_set(rj_bob[0].u, receiver_rj[0].u);
+    element_set(rj_bob[0].v, receiver_rj[0].v);
+    element_set(rj_bob[0].w, receiver_rj[0].w);
 
     ccaReCiphertext RCT;
     element_init_G1(RCT.C1, pairing);
@@ -322,81 +311,114 @@ int robustTradeTest(int trade_number, int receiver_number)
     element_init_G1(RCT.C3, pairing);
     element_init_GT(RCT.C4, pairing);
     element_init_GT(RCT.C5, pairing);
-    element_init_G1(RCT.C6, pairing);
-    element_init_G1(RCT.RK2, pairing);
+    element_init_G2(RCT.C6, pairing);
+    element_init_G2(RCT.RK2, pairing);
     element_init_GT(RCT.C32, pairing);
 
-    // ReEnc time
-    start_time = clock();
-    for(i = 0; i < trade_number; i++){
-        wots_pk_from_sig(pk2, sig, message);
-        int receiversuccess = 1;
-        for (j = 0; j < WOTS_LEN; j++) {
-            if (memcmp(pk1[j], pk2[j], WOTS_N) != 0) {
-                receiversuccess = 0;
-                break;
-            }
+    // ReEnc time per trade
+    int receiversuccess = 1;
+    BenchRun(report, BENCH_REENC_STAGE, context, [&]() {
+        for (int t = 0; t < trade_number; t++) {
+            receiversuccess &= xmss_verify(sig, message, xmss_root, xmss_height);
+            ccaReEnc(pairing, PCT, rk[t], pkg_params, vk, RCT);
         }
-        printf("WOTS+ verification %s\n", receiversuccess ? "passed" : "failed");
-        ccaReEnc(pairing, PCT, rk[i], pkg_params, vk, RCT);
-    }
-    end_time = clock();
-    double reenc_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("ReEnc time: %.6f ms\n", reenc_time);
-    file = fopen("robust_trade_test.txt", "a");
-    fprintf(file, "ReEnc time: %.6f ms\n", reenc_time);
-    fclose(file);
-
-
-    // Decryption time for the receiver
-    start_time = clock();
-    for(i = 0; i < trade_number; i++){
-        wots_pk_from_sig(pk2, sig, message);
-        int sign_flan = 1;
-        for (j = 0; j < WOTS_LEN; j++) {
-            if (memcmp(pk1[j], pk2[j], WOTS_N) != 0) {
-                sign_flan = 0;
-                break;
-            }
+    }, trade_number);
+    printf("WOTS+ verification %s\n", receiversuccess ? "passed" : "failed");
+
+
+    // Decryption time for the receiver per trade, keys are prepared once for all trades
+    PreparedUserPrivateKey User_Bob_Prepared, User_Alice_Prepared;
+    PreparedTimeTrapDoor Time_St_Prepared;
+    PrepareUserPrivateKey(pairing, User_Bob_Priv, User_Bob_Prepared);
+    PrepareTimeTrapDoor(pairing, Time_St, Time_St_Prepared);
+    int sign_flan = 1;
+    BenchRun(report, BENCH_RECEIVER_DEC, context, [&]() {
+        for (int t = 0; t < trade_number; t++) {
+            sign_flan &= xmss_verify(sig, message, xmss_root, xmss_height);
+            ccaDec1(pairing, User_Bob_Prepared, rj_bob[t], X[t]);
+            ccaDec2(pairing, User_Bob_Prepared, RCT, Time_St_Prepared, rj_bob[t], X[t], PT_Bob);
         }
-        printf("WOTS+ verification %s\n", sign_flan ? "passed" : "failed");
-        element_t X;
-        element_init_GT(X, pairing);
-        ccaDec1(pairing, User_Bob_Priv, rj_bob[i], X);
-        ccaDec2(pairing, User_Bob_Priv, RCT, Time_St , rj_bob[i], X, PT_Bob);
-    }
-    end_time = clock();
-    double receiver_dec_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000; 
-    printf("Decryption time for the receiver: %.6f ms\n", receiver_dec_time);
-    file = fopen("robust_trade_test.txt", "a"); 
-    fprintf(file, "Decryption time for the receiver: %.6f ms\n", receiver_dec_time);
-    fclose(file);
-
-    // Decryption time for sender
-    start_time = clock();
-    for(i = 0; i < trade_number; i++){
-        wots_pk_from_sig(pk2, sig, message);
-        sign_flan = 1;
-        for (j = 0; j < WOTS_LEN; j++) {
-            if (memcmp(pk1[j], pk2[j], WOTS_N) != 0) {
-                sign_flan = 0;
-                break;
-            }
+    }, trade_number);
+    printf("WOTS+ verification %s\n", sign_flan ? "passed" : "failed");
+
+    // Decryption time for sender per trade
+    PrepareUserPrivateKey(pairing, User_Alice_Priv, User_Alice_Prepared);
+    sign_flan = 1;
+    BenchRun(report, BENCH_SENDER_DEC, context, [&]() {
+        for (int t = 0; t < trade_number; t++) {
+            sign_flan &= xmss_verify(sig, message, xmss_root, xmss_height);
+            ccaSenderDec(pairing, User_Alice_Prepared, Time_St_Prepared, PCT, PT_Alice);
         }
-        printf("WOTS+ verification %s\n", sign_flan ? "passed" : "failed");
-        ccaSenderDec(pairing, pkg_params, ts_params, User_Alice_Priv, Time_St, PCT, PT_Alice);
+    }, trade_number);
+    printf("WOTS+ verification %s\n", sign_flan ? "passed" : "failed");
+
+    // Heap allocations per trade, warm arena against cold. PBC and GMP still allocate
+    // inside pow and pairing, ccamain checks that none of it outlives a trade
+    auto trade = [&](bool cold) {
+        if (cold) ScratchArenaRelease();
+        ccaEnc(pairing, pkg_params, ts_params, user_Alice_Pub, User_Alice_Priv, Time_Pub, vk, PT, PCT);
+        if (cold) ScratchArenaRelease();
+        ccaRkGen(pairing, User_Alice_Priv, PCT, rk[0], PX[0]);
+        if (cold) ScratchArenaRelease();
+        ccaRjGen(pairing, pkg_params, user_Bob_Pub, PX[0], k3, rj_bob[0]);
+        if (cold) ScratchArenaRelease();
+        ccaReEnc(pairing, PCT, rk[0], pkg_params, vk, RCT);
+        if (cold) ScratchArenaRelease();
+        ccaDec1(pairing, User_Bob_Prepared, rj_bob[0], X[0]);
+        if (cold) ScratchArenaRelease();
+        ccaDec2(pairing, User_Bob_Prepared, RCT, Time_St_Prepared, rj_bob[0], X[0], PT_Bob);
+        if (cold) ScratchArenaRelease();
+        ccaSenderDec(pairing, User_Alice_Prepared, Time_St_Prepared, PCT, PT_Alice);
+    };
+
+    trade(false);
+    pbc_set_memory_functions(count_malloc, count_realloc, count_free);
+    mp_set_memory_functions(count_malloc, count_mp_realloc, count_mp_free);
+    alloc_count = 0;
+    for (i = 0; i < ALLOC_COUNT_RENUM; i++) {
+        trade(false);
+    }
+    long warm_allocs = alloc_count;
+
+    // the same trades with every temporary freshly initialised, as before the arena
+    alloc_count = 0;
+    for (i = 0; i < ALLOC_COUNT_RENUM; i++) {
+        trade(true);
+    }
+    long cold_allocs = alloc_count;
+
+    mp_set_memory_functions(NULL, NULL, NULL);
+    pbc_set_memory_functions(malloc, realloc, free);
+
+    printf("Heap allocations per trade: %.1f warm arena, %.1f cold arena\n", (double)warm_allocs / ALLOC_COUNT_RENUM, (double)cold_allocs / ALLOC_COUNT_RENUM);
+
+    if (element_cmp(PT, PT_Bob) || element_cmp(PT, PT_Alice))
+    {
+        printf("[FAIL] Steady-state decryption mismatch.\n");
+        exit(1);
+    }
+    element_clear(k3);
+    BenchRecordValue(report, BENCH_ALLOCS_WARM, context, (double)warm_allocs / ALLOC_COUNT_RENUM);
+    BenchRecordValue(report, BENCH_ALLOCS_COLD, context, (double)cold_allocs / ALLOC_COUNT_RENUM);
+
+    BenchPrint(report);
+    char path_prefix[64];
+    snprintf(path_prefix, sizeof(path_prefix), "robust_trade_test_%d_%d", trade_number, receiver_number);
+    if (!BenchWrite(report, path_prefix))
+    {
+        exit(1);
     }
-    end_time = clock();
-    double sender_dec_time = (double)(end_time - start_time) / CLOCKS_PER_SEC * 1000;
-    printf("Decryption time for sender: %.6f ms\n", sender_dec_time);
-    file = fopen("robust_trade_test.txt", "a");
-    fprintf(file, "Decryption time for sender: %.6f ms\n\n", sender_dec_time);
-    fclose(file);
 
 
     // clear memory
+    PreparedUserPrivateKeyClear(User_Bob_Prepared);
+    PreparedUserPrivateKeyClear(User_Alice_Prepared);
+    PreparedTimeTrapDoorClear(Time_St_Prepared);
+
     element_clear(pkg_priv);
+    PkgParamsPrecomputeClear(pkg_params);
     element_clear(pkg_params.g);
+    element_clear(pkg_params.g2);
     element_clear(pkg_params.h);
     element_clear(pkg_params.g1);
     element_clear(pkg_params.e_g_g);
@@ -427,7 +449,9 @@ int robustTradeTest(int trade_number, int receiver_number)
     element_clear(RCT.C32);
 
     element_clear(ts_priv);
+    TsParamsPrecomputeClear(ts_params);
     element_clear(ts_params.g);
+    element_clear(ts_params.g2);
     element_clear(ts_params.h);
     element_clear(ts_params.g1);
     element_clear(ts_params.e_g_g);
@@ -448,6 +472,11 @@ int robustTradeTest(int trade_number, int receiver_number)
         element_clear(rj_bob[i].v);
         element_clear(rj_bob[i].w);
     }
+    for (i = 0; i < receiver_number; i++) {
+        element_clear(receiver_rj[i].u);
+        element_clear(receiver_rj[i].v);
+        element_clear(receiver_rj[i].w);
+    }
 
 
 
@@ -457,7 +486,7 @@ int robustTradeTest(int trade_number, int receiver_number)
 
     element_clear(user_Bob_Pub);
 
-    pairing_clear(pairing);
+    delete xmss_key;
 
     return 1;
 }
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: ziyidong.cs@gmail.com
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pbc.h"
+#include "scratch.h"
+
+// One arena per thread, bound to the pairing of the outermost open frame
+typedef struct ScratchArena
+{
+    pairing_ptr pairing;
+    int depth;                              // open frames
+    int top[SCRATCH_GROUPS];                // next free slot per group
+    Element *slots[SCRATCH_GROUPS];         // allocated on first bind
+} ScratchArena;
+
+static thread_local ScratchArena arena = {NULL, 0, {0}, {NULL}};
+
+
+void Element::Init(pairing_ptr pairing, ScratchGroup group)
+{
+    Clear();
+    switch (group)
+    {
+    case SCRATCH_G1:
+        element_init_G1(e, pairing);
+        break;
+    case SCRATCH_G2:
+        element_init_G2(e, pairing);
+        break;
+    case SCRATCH_GT:
+        element_init_GT(e, pairing);
+        break;
+    default:
+        element_init_Zr(e, pairing);
+        break;
+    }
+    initialised = true;
+}
+
+void Element::Clear()
+{
+    if (initialised)
+    {
+        element_clear(e);
+        initialised = false;
+    }
+}
+
+
+void ScratchArenaRelease()
+{
+    if (arena.depth)
+    {
+        fprintf(stderr, "[FAIL] Scratch arena released inside an open frame.\n");
+        exit(1);
+    }
+    for (int g = 0; g < SCRATCH_GROUPS; g++)
+    {
+        delete[] arena.slots[g];
+        arena.slots[g] = NULL;
+        arena.top[g] = 0;
+    }
+    arena.pairing = NULL;
+}
+
+ScratchFrame::ScratchFrame(pairing_ptr pairing)
+{
+    if (arena.pairing != pairing)
+    {
+        if (arena.depth)
+        {
+            fprintf(stderr, "[FAIL] Scratch frames on two pairings are nested.\n");
+            exit(1);
+        }
+        ScratchArenaRelease();
+        for (int g = 0; g < SCRATCH_GROUPS; g++)
+        {
+            arena.slots[g] = new Element[SCRATCH_SLOTS];
+        }
+        arena.pairing = pairing;
+    }
+    arena.depth++;
+    for (int g = 0; g < SCRATCH_GROUPS; g++)
+    {
+        mark[g] = arena.top[g];
+    }
+}
+
+ScratchFrame::~ScratchFrame()
+{
+    for (int g = 0; g < SCRATCH_GROUPS; g++)
+    {
+        arena.top[g] = mark[g];
+    }
+    arena.depth--;
+}
+
+element_ptr ScratchFrame::Borrow(ScratchGroup group)
+{
+    if (arena.top[group] == SCRATCH_SLOTS)
+    {
+        fprintf(stderr, "[FAIL] Scratch arena exhausted, raise SCRATCH_SLOTS.\n");
+        exit(1);
+    }
+    Element &slot = arena.slots[group][arena.top[group]++];
+    if (!slot.Initialised())
+    {
+        slot.Init(arena.pairing, group);
+    }
+    return slot.get();
+}
@@ -0,0 +1,267 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: ziyidong.cs@gmail.com
+ */
+
+#include "trace.h"
+
+#ifdef ECR_TRACE
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+static const char *const trace_kind_names[TRACE_KINDS] = {"pairing", "pairing_prod", "pow_G1", "pow_G2", "pow_GT", "hash"};
+
+// One node per distinct call path, children are chained through next_sibling
+typedef struct TraceNode
+{
+    const char *name;
+    int kind;
+    int parent, first_child, next_sibling;
+    uint64_t calls, ticks;
+} TraceNode;
+
+typedef struct TraceTree
+{
+    std::vector<TraceNode> nodes;
+    int current;
+} TraceTree;
+
+static void trace_tree_init(TraceTree &tree)
+{
+    tree.nodes.assign(1, TraceNode{"all", TRACE_KINDS, -1, -1, -1, 0, 0});
+    tree.current = 0;
+}
+
+static int trace_child(TraceTree &tree, int parent, const char *name, int kind)
+{
+    int c;
+    for (c = tree.nodes[parent].first_child; c >= 0; c = tree.nodes[c].next_sibling)
+    {
+        TraceNode &node = tree.nodes[c];
+        if (node.kind == kind && (node.name == name || !strcmp(node.name, name)))
+        {
+            return c;
+        }
+    }
+    c = (int)tree.nodes.size();
+    tree.nodes.push_back(TraceNode{name, kind, parent, -1, tree.nodes[parent].first_child, 0, 0});
+    tree.nodes[parent].first_child = c;
+    return c;
+}
+
+// Adds the counts under src_node to dst_node, creating paths as needed
+static void trace_merge(TraceTree &dst, int dst_node, TraceTree &src, int src_node)
+{
+    dst.nodes[dst_node].calls += src.nodes[src_node].calls;
+    dst.nodes[dst_node].ticks += src.nodes[src_node].ticks;
+    for (int c = src.nodes[src_node].first_child; c >= 0; c = src.nodes[c].next_sibling)
+    {
+        int d = trace_child(dst, dst_node, src.nodes[c].name, src.nodes[c].kind);
+        trace_merge(dst, d, src, c);
+    }
+}
+
+// Counts are zeroed but the nodes kept, open spans still point into them
+static void trace_zero(TraceTree &tree)
+{
+    for (TraceNode &node : tree.nodes)
+    {
+        node.calls = 0;
+        node.ticks = 0;
+    }
+}
+
+static std::mutex trace_lock;
+static TraceTree trace_merged;
+
+// Caller holds trace_lock
+static void trace_flush(TraceTree &tree)
+{
+    if (trace_merged.nodes.empty())
+    {
+        trace_tree_init(trace_merged);
+    }
+    trace_merge(trace_merged, 0, tree, 0);
+    trace_zero(tree);
+}
+
+// Each thread records into its own tree and folds it into trace_merged on exit
+struct TraceThread
+{
+    TraceTree tree;
+    TraceThread() { trace_tree_init(tree); }
+    ~TraceThread()
+    {
+        std::lock_guard<std::mutex> guard(trace_lock);
+        trace_flush(tree);
+    }
+};
+
+static thread_local TraceThread trace_thread;
+
+static uint64_t trace_ns()
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+uint64_t TraceNow()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return trace_ns();
+#endif
+}
+
+// Tick rate is measured over the run, from static init to the dump
+static const uint64_t trace_start_ticks = TraceNow();
+static const uint64_t trace_start_ns = trace_ns();
+
+void TraceEnter(const char *name, int kind)
+{
+    TraceTree &tree = trace_thread.tree;
+    tree.current = trace_child(tree, tree.current, name ? name : trace_kind_names[kind], kind);
+    tree.nodes[tree.current].calls++;
+}
+
+void TraceExit(uint64_t ticks)
+{
+    TraceTree &tree = trace_thread.tree;
+    tree.nodes[tree.current].ticks += ticks;
+    tree.current = tree.nodes[tree.current].parent;
+}
+
+void TraceReset()
+{
+    std::lock_guard<std::mutex> guard(trace_lock);
+    trace_tree_init(trace_merged);
+    trace_zero(trace_thread.tree);
+}
+
+
+// Primitive calls of each kind in the subtree under node
+static void trace_kind_counts(TraceTree &tree, int node, uint64_t counts[TRACE_KINDS])
+{
+    if (tree.nodes[node].kind < TRACE_KINDS)
+    {
+        counts[tree.nodes[node].kind] += tree.nodes[node].calls;
+    }
+    for (int c = tree.nodes[node].first_child; c >= 0; c = tree.nodes[c].next_sibling)
+    {
+        trace_kind_counts(tree, c, counts);
+    }
+}
+
+static uint64_t trace_self_ticks(TraceTree &tree, int node)
+{
+    uint64_t children = 0;
+    for (int c = tree.nodes[node].first_child; c >= 0; c = tree.nodes[c].next_sibling)
+    {
+        children += tree.nodes[c].ticks;
+    }
+    return tree.nodes[node].ticks > children ? tree.nodes[node].ticks - children : 0;
+}
+
+static void trace_print(TraceTree &tree, int node, int depth, double ns_per_tick, double root_ticks)
+{
+    TraceNode &n = tree.nodes[node];
+    if (!n.calls)
+    {
+        return;
+    }
+    uint64_t counts[TRACE_KINDS] = {0};
+    trace_kind_counts(tree, node, counts);
+
+    printf("%*s%-*s %10lu calls %12.3f ms %12.3f ms self %6.2f%%", depth * 2, "", 28 - depth * 2, n.name, (unsigned long)n.calls,
+           n.ticks * ns_per_tick / 1e6, trace_self_ticks(tree, node) * ns_per_tick / 1e6, root_ticks ? 100.0 * n.ticks / root_ticks : 0.0);
+    if (n.kind == TRACE_KINDS)
+    {
+        for (int k = 0; k < TRACE_KINDS; k++)
+        {
+            if (counts[k])
+            {
+                printf(", %s %lu", trace_kind_names[k], (unsigned long)counts[k]);
+            }
+        }
+    }
+    printf("\n");
+
+    for (int c = n.first_child; c >= 0; c = tree.nodes[c].next_sibling)
+    {
+        trace_print(tree, c, depth + 1, ns_per_tick, root_ticks);
+    }
+}
+
+static void trace_fold(TraceTree &tree, int node, std::string &stack, double ns_per_tick, FILE *file)
+{
+    size_t length = stack.size();
+    if (node)
+    {
+        if (length)
+        {
+            stack += ';';
+        }
+        stack += tree.nodes[node].name;
+        uint64_t self_ns = (uint64_t)(trace_self_ticks(tree, node) * ns_per_tick);
+        if (self_ns)
+        {
+            fprintf(file, "%s %lu\n", stack.c_str(), (unsigned long)self_ns);
+        }
+    }
+    for (int c = tree.nodes[node].first_child; c >= 0; c = tree.nodes[c].next_sibling)
+    {
+        trace_fold(tree, c, stack, ns_per_tick, file);
+    }
+    stack.resize(length);
+}
+
+int TraceDump(const char *path_prefix)
+{
+    std::lock_guard<std::mutex> guard(trace_lock);
+    trace_flush(trace_thread.tree);
+
+    uint64_t elapsed_ticks = TraceNow() - trace_start_ticks;
+    double ns_per_tick = elapsed_ticks ? (double)(trace_ns() - trace_start_ns) / elapsed_ticks : 1.0;
+
+    // the root is never entered, its time is that of the top-level spans
+    TraceNode &root = trace_merged.nodes[0];
+    root.ticks = 0;
+    root.calls = 1;
+    for (int c = root.first_child; c >= 0; c = trace_merged.nodes[c].next_sibling)
+    {
+        root.ticks += trace_merged.nodes[c].ticks;
+    }
+
+    printf("=== Trace Summary ===\n");
+    trace_print(trace_merged, 0, 0, ns_per_tick, (double)root.ticks);
+
+    std::string path = std::string(path_prefix) + ".folded";
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file)
+    {
+        perror("[FAIL] Trace output open fail.");
+        return 0;
+    }
+    std::string stack;
+    trace_fold(trace_merged, 0, stack, ns_per_tick, file);
+    fclose(file);
+    return 1;
+}
+
+#endif
@@ -11,10 +11,28 @@
 #include "hash.h"
 #include <string.h>
 
-static void gen_chain(uint8_t *out, const uint8_t *in, int start, int steps) {
-    memcpy(out, in, WOTS_N);
-    for (int i = start; i < start + steps && i < WOTS_W; i++) {
-        hash_sha256(out, WOTS_N, out);
+// the 32-byte hash kernels assume one chain value is one SHA-256 digest
+static_assert(WOTS_N == 32, "WOTS_N must be 32");
+
+// Runs all WOTS_LEN chains: chain i takes steps[i] hashes from position
+// start[i], capped at WOTS_W
+static void gen_chains(uint8_t out[WOTS_LEN][WOTS_N], const uint8_t in[WOTS_LEN][WOTS_N],
+                       const int *start, const int *steps) {
+    int count[WOTS_LEN];
+    uint8_t *chain[WOTS_LEN];
+    for (int i = 0; i < WOTS_LEN; i++) {
+        memcpy(out[i], in[i], WOTS_N);
+        int end = start[i] + steps[i] < WOTS_W ? start[i] + steps[i] : WOTS_W;
+        count[i] = end > start[i] ? end - start[i] : 0;
+        chain[i] = out[i];
+    }
+    hash_sha256_32_chains(chain, count, WOTS_LEN);
+}
+
+// Chain i starts from its own secret, PRF(sk_seed, i) = SHA256(sk_seed || i)
+static void expand_sk(uint8_t sk[WOTS_LEN][WOTS_N], const uint8_t *sk_seed) {
+    for (int i = 0; i < WOTS_LEN; i++) {
+        hash_sha256_32_indexed(sk[i], sk_seed, (uint32_t)i);
     }
 }
 
@@ -40,7 +58,9 @@ static void compute_lengths(const uint8_t *message, int *lengths) {
         csum += WOTS_W - 1 - msg_base[i];
     }
 
-    uint8_t csum_bytes[2] = { (csum >> 8) & 0xFF, csum & 0xFF };
+    // left-align the WOTS_LEN2 * WOTS_LOGW checksum bits in the two bytes base_w reads from the top
+    csum <<= (8 - ((WOTS_LEN2 * WOTS_LOGW) % 8)) % 8;
+    uint8_t csum_bytes[2] = { (uint8_t)((csum >> 8) & 0xFF), (uint8_t)(csum & 0xFF) };
     int csum_base[WOTS_LEN2];
     base_w(csum_base, csum_bytes, WOTS_LEN2);
 
@@ -51,11 +71,14 @@ static void compute_lengths(const uint8_t *message, int *lengths) {
 
 void wots_keygen(uint8_t pk[WOTS_LEN][WOTS_N],
                  const uint8_t *sk_seed) {
+    uint8_t sk[WOTS_LEN][WOTS_N];
+    int start[WOTS_LEN], steps[WOTS_LEN];
+    expand_sk(sk, sk_seed);
     for (int i = 0; i < WOTS_LEN; i++) {
-        uint8_t sk[WOTS_N];
-        hash_sha256(sk_seed, WOTS_N, sk);  // PRF(sk_seed, i) 可改进
-        gen_chain(pk[i], sk, 0, WOTS_W - 1);
+        start[i] = 0;
+        steps[i] = WOTS_W - 1;
     }
+    gen_chains(pk, sk, start, steps);
 }
 
 void wots_sign(uint8_t sig[WOTS_LEN][WOTS_N],
@@ -64,11 +87,13 @@ void wots_sign(uint8_t sig[WOTS_LEN][WOTS_N],
     int lengths[WOTS_LEN];
     compute_lengths(message, lengths);
 
+    uint8_t sk[WOTS_LEN][WOTS_N];
+    int start[WOTS_LEN];
+    expand_sk(sk, sk_seed);
     for (int i = 0; i < WOTS_LEN; i++) {
-        uint8_t sk[WOTS_N];
-        hash_sha256(sk_seed, WOTS_N, sk);  // PRF(sk_seed, i) 可替换
-        gen_chain(sig[i], sk, 0, lengths[i]);
+        start[i] = 0;
     }
+    gen_chains(sig, sk, start, lengths);
 }
 
 void wots_pk_from_sig(uint8_t pk[WOTS_LEN][WOTS_N],
@@ -77,7 +102,104 @@ void wots_pk_from_sig(uint8_t pk[WOTS_LEN][WOTS_N],
     int lengths[WOTS_LEN];
     compute_lengths(message, lengths);
 
+    int steps[WOTS_LEN];
     for (int i = 0; i < WOTS_LEN; i++) {
-        gen_chain(pk[i], sig[i], lengths[i], WOTS_W - 1 - lengths[i]);
+        steps[i] = WOTS_W - 1 - lengths[i];
+    }
+    gen_chains(pk, sig, lengths, steps);
+}
+
+void wots_pk_compress(uint8_t pk_root[WOTS_N],
+                      const uint8_t pk[WOTS_LEN][WOTS_N]) {
+    hash_sha256(&pk[0][0], WOTS_LEN * WOTS_N, pk_root);
+}
+
+void wots_keygen_root(uint8_t pk_root[WOTS_N],
+                      const uint8_t *sk_seed) {
+    uint8_t pk[WOTS_LEN][WOTS_N];
+    wots_keygen(pk, sk_seed);
+    wots_pk_compress(pk_root, pk);
+}
+
+bool wots_verify(const uint8_t sig[WOTS_LEN][WOTS_N],
+                 const uint8_t *message,
+                 const uint8_t pk_root[WOTS_N]) {
+    uint8_t pk[WOTS_LEN][WOTS_N];
+    uint8_t root[WOTS_N];
+    wots_pk_from_sig(pk, sig, message);
+    wots_pk_compress(root, pk);
+    return memcmp(root, pk_root, WOTS_N) == 0;
+}
+
+void wots_keygen_cached(uint8_t pk_root[WOTS_N],
+                        const uint8_t *sk_seed,
+                        WotsKeyCache &cache) {
+    uint8_t sk[WOTS_LEN][WOTS_N];
+    expand_sk(sk, sk_seed);
+
+    // one multi-buffer call per chain position, position j + 1 hashed from j
+    uint8_t *out[WOTS_LEN];
+    const uint8_t *in[WOTS_LEN];
+    for (int i = 0; i < WOTS_LEN; i++) {
+        memcpy(cache.chain[i][0], sk[i], WOTS_N);
+    }
+    for (int j = 0; j < WOTS_W - 1; j++) {
+        for (int i = 0; i < WOTS_LEN; i++) {
+            in[i] = cache.chain[i][j];
+            out[i] = cache.chain[i][j + 1];
+        }
+        hash_sha256_32_multi(out, in, WOTS_LEN);
+    }
+
+    uint8_t pk[WOTS_LEN][WOTS_N];
+    for (int i = 0; i < WOTS_LEN; i++) {
+        memcpy(pk[i], cache.chain[i][WOTS_W - 1], WOTS_N);
+    }
+    wots_pk_compress(pk_root, pk);
+}
+
+void wots_sign_cached(uint8_t sig[WOTS_LEN][WOTS_N],
+                      const uint8_t *message,
+                      WotsKeyCache &cache) {
+    int lengths[WOTS_LEN];
+    compute_lengths(message, lengths);
+
+    for (int i = 0; i < WOTS_LEN; i++) {
+        memcpy(sig[i], cache.chain[i][lengths[i]], WOTS_N);
+    }
+}
+
+void wots_keygen_batch(WotsKeyBatch &batch, const uint8_t *sk_seed, int begin, int end) {
+    uint8_t group[WOTS_LEN][WOTS_BATCH_LANES][WOTS_N];
+    uint8_t *chain[WOTS_LEN * WOTS_BATCH_LANES];
+    int steps[WOTS_LEN * WOTS_BATCH_LANES];
+
+    for (int k0 = begin; k0 < end; k0 += WOTS_BATCH_LANES) {
+        int lanes = end - k0 < WOTS_BATCH_LANES ? end - k0 : WOTS_BATCH_LANES;
+
+        // chains start in place, in the caller's SoA buffer when there is one
+        int n = 0;
+        for (int k = 0; k < lanes; k++) {
+            uint8_t seed[WOTS_N];
+            hash_sha256_32_indexed(seed, sk_seed, batch.first + (uint32_t)(k0 + k));
+            for (int c = 0; c < WOTS_LEN; c++) {
+                uint8_t *node = batch.pk ? batch.pk + WOTS_BATCH_OFFSET(c, k0 + k, batch.count) : group[c][k];
+                hash_sha256_32_indexed(node, seed, (uint32_t)c);
+                chain[n] = node;
+                steps[n] = WOTS_W - 1;
+                n++;
+            }
+        }
+        hash_sha256_32_chains(chain, steps, n);
+
+        if (batch.root) {
+            for (int k = 0; k < lanes; k++) {
+                uint8_t pk[WOTS_LEN][WOTS_N];
+                for (int c = 0; c < WOTS_LEN; c++) {
+                    memcpy(pk[c], chain[k * WOTS_LEN + c], WOTS_N);
+                }
+                wots_pk_compress(batch.root[k0 + k], pk);
+            }
+        }
     }
 }
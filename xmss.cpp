@@ -0,0 +1,256 @@
+/*
+ * @Coding: UTF-8
+ * @Author: Ziyi Dong
+ * @Created: 10-17-2026
+ * @Last Modified: 10-17-2026
+ * @Copyright: © 2025 Ziyi Dong. All rights reserved.
+ * @License: GPL v3.0
+ * @Contact: ziyidong.cs@gmail.com
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wots.h"
+#include "hash.h"
+#include "xmss.h"
+#include "fanout.h"
+
+// Leaves generated in parallel per block while the tree is built
+#define XMSS_LEAF_BLOCK 1024
+
+// Leaf idx signs with its own WOTS seed, PRF(sk_seed, idx)
+static void leaf_seed(uint8_t seed[WOTS_N], const XmssKey &key, uint32_t idx) {
+    hash_sha256_32_indexed(seed, key.sk_seed, idx);
+}
+
+static void gen_leaf(uint8_t leaf[WOTS_N], const XmssKey &key, uint32_t idx) {
+    uint8_t seed[WOTS_N];
+    leaf_seed(seed, key, idx);
+    wots_keygen_root(leaf, seed);
+}
+
+static void hash_node(uint8_t out[WOTS_N], const uint8_t *left, const uint8_t *right) {
+    uint8_t buf[2 * WOTS_N];
+    memcpy(buf, left, WOTS_N);
+    memcpy(buf + WOTS_N, right, WOTS_N);
+    hash_sha256(buf, 2 * WOTS_N, out);
+}
+
+// Slot in retain of the right node at position pos (odd, >= 3) on a top level
+static int retain_slot(int height, int level, uint32_t pos) {
+    return (1 << (height - 1 - level)) + level - height + (int)((pos - 3) >> 1);
+}
+
+
+// Whole tree as one treehash run. Right nodes on the way are kept: position 1 of
+// each level is the first auth path, position 3 seeds the level's treehash and
+// the rest of the top levels go to retain.
+static void build_tree(XmssKey &key) {
+    int h = key.height;
+    uint8_t stack[XMSS_MAX_HEIGHT + 1][WOTS_N];
+    int levels[XMSS_MAX_HEIGHT + 1];
+    int top = 0;
+
+    int block = (1 << h) < XMSS_LEAF_BLOCK ? (1 << h) : XMSS_LEAF_BLOCK;
+    uint8_t (*leaves)[WOTS_N] = new uint8_t[block][WOTS_N];
+    WotsKeyBatch batch;
+    batch.count = block;
+    batch.pk = NULL;
+    batch.root = leaves;
+
+    for (int i = 0; i < h - XMSS_BDS_K; i++) {
+        key.treehash[i].height = i;
+        key.treehash[i].completed = 1;
+        key.treehash[i].stackusage = 0;
+    }
+
+    for (uint32_t idx = 0; idx < (1u << h); idx++) {
+        if (idx % block == 0) {
+            batch.first = idx;
+            wots_keygen_parallel(batch, key.sk_seed, 0);
+        }
+        memcpy(stack[top], leaves[idx % block], WOTS_N);
+        levels[top] = 0;
+        top++;
+        while (top > 1 && levels[top - 1] == levels[top - 2]) {
+            int level = levels[top - 1];
+            uint32_t pos = idx >> level;
+            if (pos == 1) {
+                memcpy(key.auth[level], stack[top - 1], WOTS_N);
+            } else if (level < h - XMSS_BDS_K && pos == 3) {
+                memcpy(key.treehash[level].node, stack[top - 1], WOTS_N);
+            } else if (level >= h - XMSS_BDS_K) {
+                memcpy(key.retain[retain_slot(h, level, pos)], stack[top - 1], WOTS_N);
+            }
+            hash_node(stack[top - 2], stack[top - 2], stack[top - 1]);
+            levels[top - 2]++;
+            top--;
+        }
+    }
+    memcpy(key.root, stack[0], WOTS_N);
+    delete[] leaves;
+}
+
+// Lowest level a treehash instance has pushed onto the shared stack
+static int treehash_min_level(XmssKey &key, XmssTreehash &th) {
+    int low = key.height;
+    for (int i = 0; i < th.stackusage; i++) {
+        if (key.stacklevels[key.stackoffset - i - 1] < low) {
+            low = key.stacklevels[key.stackoffset - i - 1];
+        }
+    }
+    return low;
+}
+
+// One leaf of work for th, merged with whatever it left on the shared stack
+static void treehash_step(XmssKey &key, XmssTreehash &th) {
+    uint8_t node[WOTS_N];
+    int level = 0;
+    gen_leaf(node, key, th.next_idx);
+    while (th.stackusage > 0 && key.stacklevels[key.stackoffset - 1] == level) {
+        hash_node(node, key.stack[key.stackoffset - 1], node);
+        level++;
+        th.stackusage--;
+        key.stackoffset--;
+    }
+    if (level == th.height) {
+        memcpy(th.node, node, WOTS_N);
+        th.completed = 1;
+    } else {
+        memcpy(key.stack[key.stackoffset], node, WOTS_N);
+        key.stacklevels[key.stackoffset] = level;
+        key.stackoffset++;
+        th.stackusage++;
+        th.next_idx++;
+    }
+}
+
+// Spends up to updates leaf computations on the unfinished instance whose
+// stack reaches lowest, so the nearest auth node is ready first
+static void treehash_update(XmssKey &key, int updates) {
+    int h = key.height;
+    for (int j = 0; j < updates; j++) {
+        int best = h - XMSS_BDS_K, best_low = h;
+        for (int i = 0; i < h - XMSS_BDS_K; i++) {
+            int low;
+            if (key.treehash[i].completed) {
+                low = h;
+            } else if (key.treehash[i].stackusage == 0) {
+                low = i;
+            } else {
+                low = treehash_min_level(key, key.treehash[i]);
+            }
+            if (low < best_low) {
+                best = i;
+                best_low = low;
+            }
+        }
+        if (best == h - XMSS_BDS_K) {
+            break;
+        }
+        treehash_step(key, key.treehash[best]);
+    }
+}
+
+// Moves auth from the path of leaf idx to the path of idx + 1 (BDS traversal)
+static void bds_round(XmssKey &key, uint32_t idx) {
+    int h = key.height;
+    int tau = h;
+    uint8_t left[WOTS_N], right[WOTS_N];
+
+    // tau is the lowest level whose auth node changes, the first zero bit of idx
+    for (int i = 0; i < h; i++) {
+        if (!((idx >> i) & 1)) {
+            tau = i;
+            break;
+        }
+    }
+
+    // read before keep is refreshed below
+    if (tau > 0) {
+        memcpy(left, key.auth[tau - 1], WOTS_N);
+        memcpy(right, key.keep[(tau - 1) >> 1], WOTS_N);
+    }
+    if (!((idx >> (tau + 1)) & 1) && tau < h - 1) {
+        memcpy(key.keep[tau >> 1], key.auth[tau], WOTS_N);
+    }
+
+    if (tau == 0) {
+        gen_leaf(key.auth[0], key, idx);
+        return;
+    }
+
+    hash_node(key.auth[tau], left, right);
+    for (int i = 0; i < tau; i++) {
+        if (i < h - XMSS_BDS_K) {
+            memcpy(key.auth[i], key.treehash[i].node, WOTS_N);
+        } else {
+            // the next leaf's ancestor is (idx >> i) + 1, its sibling was retained
+            memcpy(key.auth[i], key.retain[retain_slot(h, i, (idx >> i) + 2)], WOTS_N);
+        }
+    }
+    for (int i = 0; i < tau && i < h - XMSS_BDS_K; i++) {
+        uint32_t start = idx + 1 + 3 * (1u << i);
+        if (start < (1u << h)) {
+            key.treehash[i].height = i;
+            key.treehash[i].next_idx = start;
+            key.treehash[i].completed = 0;
+            key.treehash[i].stackusage = 0;
+        }
+    }
+}
+
+
+void xmss_keygen(XmssKey &key, const uint8_t *sk_seed, int height) {
+    if (height < XMSS_BDS_K || height > XMSS_MAX_HEIGHT || (height - XMSS_BDS_K) % 2 != 0) {
+        printf("[FAIL] XMSS height %d unsupported.\n", height);
+        exit(1);
+    }
+    memset(&key, 0, sizeof(key));
+    key.height = height;
+    key.next = 0;
+    memcpy(key.sk_seed, sk_seed, WOTS_N);
+    build_tree(key);
+}
+
+int xmss_sign(XmssKey &key, XmssSignature &sig, const uint8_t *message) {
+    int h = key.height;
+    uint32_t idx = key.next;
+    if (idx >= (1u << h)) {
+        return 0;
+    }
+
+    uint8_t seed[WOTS_N];
+    leaf_seed(seed, key, idx);
+    sig.index = idx;
+    wots_sign(sig.wots_sig, message, seed);
+    memset(sig.auth, 0, sizeof(sig.auth));
+    memcpy(sig.auth, key.auth, h * WOTS_N);
+
+    if (idx < (1u << h) - 1) {
+        bds_round(key, idx);
+        treehash_update(key, (h - XMSS_BDS_K) >> 1);
+    }
+    key.next = idx + 1;
+    return 1;
+}
+
+bool xmss_verify(const XmssSignature &sig, const uint8_t *message, const uint8_t root[WOTS_N], int height) {
+    if (height < 1 || height > XMSS_MAX_HEIGHT || sig.index >= (1u << height)) {
+        return false;
+    }
+
+    uint8_t pk[WOTS_LEN][WOTS_N];
+    uint8_t node[WOTS_N];
+    wots_pk_from_sig(pk, sig.wots_sig, message);
+    wots_pk_compress(node, pk);
+    for (int i = 0; i < height; i++) {
+        if ((sig.index >> i) & 1) {
+            hash_node(node, sig.auth[i], node);
+        } else {
+            hash_node(node, node, sig.auth[i]);
+        }
+    }
+    return memcmp(node, root, WOTS_N) == 0;
+}